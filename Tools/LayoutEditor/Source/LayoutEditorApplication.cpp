@@ -54,6 +54,24 @@ bool LayoutEditorApplication::moreThanOneInstanceAllowed()        { return true;
 //==============================================================================
 void LayoutEditorApplication::initialise (const String& commandLine)
 {
+    // command line mode to precompile layouts at build time:
+    // LayoutEditor --compile layout.xml layout.bin
+    StringArray args = StringArray::fromTokens (commandLine, true);
+    const int compileIndex = args.indexOf ("--compile");
+    if (compileIndex >= 0) {
+        const bool succeeded = compileLayout (args [compileIndex + 1].unquoted(), args [compileIndex + 2].unquoted());
+        setApplicationReturnValue (succeeded ? 0 : 1);
+        quit();
+        return;
+    }
+
+    // LayoutEditor --benchmark runs the timing tests of the ff_layout module
+    if (args.contains ("--benchmark")) {
+        setApplicationReturnValue (runBenchmarks() ? 0 : 1);
+        quit();
+        return;
+    }
+
     commandManager = new ApplicationCommandManager();
     menuBar = new EditorMenuBar;
     menuBar->setApplicationCommandManagerToWatch (commandManager);
@@ -73,6 +91,49 @@ void LayoutEditorApplication::initialise (const String& commandLine)
 
 }
 
+bool LayoutEditorApplication::compileLayout (const String& inputPath, const String& outputPath)
+{
+    if (inputPath.isEmpty() || outputPath.isEmpty()) {
+        Logger::writeToLog ("Usage: LayoutEditor --compile <layout.xml> <layout.bin>");
+        return false;
+    }
+    File input  = File::getCurrentWorkingDirectory().getChildFile (inputPath);
+    File output = File::getCurrentWorkingDirectory().getChildFile (outputPath);
+    if (!input.existsAsFile()) {
+        Logger::writeToLog ("Layout file not found: " + input.getFullPathName());
+        return false;
+    }
+
+    MemoryOutputStream binary;
+    String error;
+    if (!Layout::convertXmlToBinary (input.loadFileAsString(), binary, &error)) {
+        Logger::writeToLog (input.getFullPathName() + ":" + error);
+        return false;
+    }
+    if (!output.replaceWithData (binary.getData(), binary.getDataSize())) {
+        Logger::writeToLog ("Could not write: " + output.getFullPathName());
+        return false;
+    }
+    return true;
+}
+
+bool LayoutEditorApplication::runBenchmarks ()
+{
+#if FF_LAYOUT_BENCHMARKS
+    UnitTestRunner runner;
+    runner.runTestsInCategory ("ffLayout benchmarks");
+    for (int i=0; i < runner.getNumResults(); ++i) {
+        if (runner.getResult (i)->failures > 0) {
+            return false;
+        }
+    }
+    return true;
+#else
+    Logger::writeToLog ("The ff_layout module was built without FF_LAYOUT_BENCHMARKS");
+    return false;
+#endif
+}
+
 void LayoutEditorApplication::shutdown()
 {
     // Add your application's shutdown code here..
@@ -98,6 +98,12 @@ public:
     };
     
 private:
+    /** Convert the xml layout in inputPath into the binary layout format in outputPath */
+    static bool compileLayout (const String& inputPath, const String& outputPath);
+
+    /** Run the ffLayout benchmarks and write the times to the log */
+    static bool runBenchmarks ();
+
     ScopedPointer<ApplicationCommandManager> commandManager;
     ScopedPointer<MenuBarModel>              menuBar;
     ScopedPointer<MainWindow>                mainWindow;
@@ -66,22 +66,26 @@ const juce::Identifier Layout::settingsHeight       ("height");
 const juce::Identifier Layout::settingsSplittersList("splittersList");
 const juce::Identifier Layout::settingsSplitterPos  ("splitterPos");
 
+const juce::uint32 Layout::binaryLayoutMagic        = juce::ByteOrder::littleEndianInt ("ffLB");
+const int          Layout::binaryLayoutVersion      = 1;
+
 Layout::Layout (LayoutItem::Orientation o, juce::Component* owner)
 : owningComponent (owner)
 {
     state = LayoutItem (o).state;
+    state.addListener (this);
 }
 
 Layout::Layout (const juce::String& xml, juce::Component* owner)
 : owningComponent (owner)
 {
-    auto mainElement = juce::XmlDocument::parse (xml);
+    state = LayoutDefinitionCache::getInstance()->getLayoutFromXml (xml, &loadError);
     
-    // loading of the xml failed. Probably the xml was malformed, so that ValueTree could not parse it.
-    jassert (mainElement);
+    // loading of the xml failed. getLoadError tells, where the xml is malformed.
+    jassert (state.isValid());
     
-    if (mainElement) {
-        state = juce::ValueTree::fromXml (*mainElement);
+    if (state.isValid()) {
+        state.addListener (this);
         realize ();
     }
 }
@@ -90,15 +94,61 @@ Layout::Layout (const juce::ValueTree& state_, juce::Component* owner)
 : owningComponent (owner)
 {
     state = state_;
-    LayoutItem root (state);
+    state.addListener (this);
     realize ();
 }
 
+Layout::Layout (const void* data, size_t size, juce::Component* owner)
+: owningComponent (owner)
+{
+    state = LayoutDefinitionCache::getInstance()->getLayoutFromBinary (data, size);
+
+    // the data is not a binary layout or it was written by a newer version
+    jassert (state.isValid());
+
+    if (state.isValid()) {
+        state.addListener (this);
+        realize ();
+    }
+}
+
+Layout::Layout (PreparedLayout& prepared, juce::Component* owner)
+: owningComponent (owner),
+  plan (prepared.plan ? prepared.plan.release() : new LayoutPlan())
+{
+    // the tree is bound to the plan now, a second layout must not share it
+    state = prepared.state;
+    prepared.state = juce::ValueTree();
+
+    // loading failed, see prepared.errorMessage
+    jassert (state.isValid());
+
+    if (state.isValid()) {
+        state.addListener (this);
+        realize ();
+    }
+}
+
 Layout::~Layout ()
 {
+    cancelPendingUpdate();
+    if (LayoutScheduler* scheduler = LayoutScheduler::getInstanceWithoutCreating()) {
+        scheduler->remove (this);
+    }
+    state.removeListener (this);
     masterReference.clear();
 }
 
+const juce::StringArray& Layout::getUnresolvedComponents() const
+{
+    return unresolvedComponents;
+}
+
+const juce::String& Layout::getLoadError() const
+{
+    return loadError;
+}
+
 juce::Component* Layout::getOwningComponent()
 {
     return owningComponent;
@@ -119,7 +169,81 @@ void Layout::removeComponent (juce::Component* component)
 
 juce::ValueTree Layout::getLayoutItem (juce::Component* component)
 {
-    return LayoutItem::getLayoutItem (state, component);
+    const bool wasValid = itemIndexValid;
+    if (!itemIndexValid) {
+        buildItemIndex();
+    }
+    auto found = componentIndex.find (component);
+    if (found != componentIndex.end()) {
+        const juce::ValueTree node = found->second;
+        if (isInLayout (node) && LayoutItem (node).getComponent() == component) {
+            return node;
+        }
+    }
+    if (wasValid) {
+        // the component might have been exchanged without notifying the tree
+        buildItemIndex();
+        found = componentIndex.find (component);
+        if (found != componentIndex.end()) {
+            return found->second;
+        }
+    }
+    return juce::ValueTree();
+}
+
+juce::ValueTree Layout::getLayoutItem (const juce::String& componentID)
+{
+    const bool wasValid = itemIndexValid;
+    if (!itemIndexValid) {
+        buildItemIndex();
+    }
+    if (componentIDIndex.contains (componentID)) {
+        const juce::ValueTree node = componentIDIndex [componentID];
+        if (isInLayout (node) && node.getProperty (LayoutItem::propComponentID).toString() == componentID) {
+            return node;
+        }
+    }
+    if (wasValid) {
+        buildItemIndex();
+        if (componentIDIndex.contains (componentID)) {
+            return componentIDIndex [componentID];
+        }
+    }
+    return juce::ValueTree();
+}
+
+void Layout::buildItemIndex ()
+{
+    componentIndex.clear();
+    componentIDIndex.clear();
+    if (state.isValid()) {
+        addToItemIndex (state);
+    }
+    itemIndexValid = true;
+}
+
+void Layout::addToItemIndex (const juce::ValueTree& node)
+{
+    // same order like LayoutItem::getLayoutItem, so the first match wins
+    if (juce::Component* component = LayoutItem (node).getComponent()) {
+        componentIndex.insert (std::make_pair (component, node));
+    }
+    if (node.hasProperty (LayoutItem::propComponentID)) {
+        const juce::String componentID = node.getProperty (LayoutItem::propComponentID).toString();
+        if (!componentIDIndex.contains (componentID)) {
+            componentIDIndex.set (componentID, node);
+        }
+    }
+    if (node.getType() == LayoutItem::itemTypeSubLayout) {
+        for (int i=0; i < node.getNumChildren(); ++i) {
+            addToItemIndex (node.getChild (i));
+        }
+    }
+}
+
+bool Layout::isInLayout (const juce::ValueTree& node) const
+{
+    return node.isValid() && (node == state || node.isAChildOf (state));
 }
 
 void Layout::clearLayout (juce::UndoManager* undo)
@@ -144,7 +268,7 @@ void Layout::setSettingsTree (juce::ValueTree settings)
                 juce::ValueTree node = splitters.getChild (i);
                 if (node.hasProperty (settingsSplitterPos)) {
                     juce::String splitterID = node.getType().toString();
-                    juce::ValueTree layoutItemNode = LayoutItem::getLayoutItem (state, splitterID);
+                    juce::ValueTree layoutItemNode = getLayoutItem (splitterID);
                     if (layoutItemNode.isValid() && layoutItemNode.getType() == LayoutItem::itemTypeSplitter) {
                         LayoutSplitter splitter (layoutItemNode);
                         splitter.setRelativePosition (node.getProperty (settingsSplitterPos));
@@ -156,6 +280,62 @@ void Layout::setSettingsTree (juce::ValueTree settings)
     updateGeometry();
 }
 
+void Layout::writeBinaryLayout (const juce::ValueTree& state, juce::OutputStream& output)
+{
+    // components and computed bounds are only valid in the running instance
+    juce::ValueTree copy = state.createCopy();
+    removeVolatileProperties (copy);
+
+    output.writeInt (static_cast<int> (binaryLayoutMagic));
+    output.writeInt (binaryLayoutVersion);
+    copy.writeToStream (output);
+}
+
+bool Layout::convertXmlToBinary (const juce::String& xml, juce::OutputStream& output, juce::String* errorMessage)
+{
+    juce::ValueTree tree = LayoutXmlReader::parse (xml, errorMessage);
+    if (tree.isValid()) {
+        writeBinaryLayout (tree, output);
+        return true;
+    }
+    return false;
+}
+
+bool Layout::isBinaryLayout (const void* data, size_t size)
+{
+    return data != nullptr
+        && size >= 2 * sizeof (juce::uint32)
+        && juce::ByteOrder::littleEndianInt (data) == binaryLayoutMagic;
+}
+
+juce::ValueTree Layout::readBinaryLayout (const void* data, size_t size)
+{
+    if (!isBinaryLayout (data, size)) {
+        return juce::ValueTree();
+    }
+    const char* bytes = static_cast<const char*> (data);
+    const int version = static_cast<int> (juce::ByteOrder::littleEndianInt (bytes + sizeof (juce::uint32)));
+    if (version < 1 || version > binaryLayoutVersion) {
+        return juce::ValueTree();
+    }
+    const size_t headerSize = 2 * sizeof (juce::uint32);
+    return juce::ValueTree::readFromData (bytes + headerSize, size - headerSize);
+}
+
+void Layout::removeVolatileProperties (juce::ValueTree& node)
+{
+    for (int i=node.getNumProperties() - 1; i >= 0; --i) {
+        const juce::Identifier name = node.getPropertyName (i);
+        if (name.toString().startsWith ("volatile")) {
+            node.removeProperty (name, nullptr);
+        }
+    }
+    for (int i=0; i < node.getNumChildren(); ++i) {
+        juce::ValueTree child = node.getChild (i);
+        removeVolatileProperties (child);
+    }
+}
+
 void Layout::layoutBoundsChanged (juce::ValueTree item, juce::Rectangle<int> newBounds)
 {
     if (currentSettings.isValid()) {
@@ -181,6 +361,8 @@ void Layout::layoutSplitterMoved (juce::ValueTree item, float relativePos, bool
 
 void Layout::realize (juce::Component* owningComponent_)
 {
+    // binding the components is no reason for another pass
+    juce::ScopedValueSetter<bool> ignore (ignoreStateChanges, true);
     LayoutItem root (state);
     
     root.addListener (this);
@@ -207,33 +389,293 @@ void Layout::realize (juce::Component* owningComponent_)
         resizeConstraints->setBoundsForComponent (owningComponent, newBounds, false, false, true, true);
         
     }
-    root.realize (state, owningComponent, this);
+    // each bound component changes a node, update the plan's sums only once
+    plan->beginNodeChanges();
+    LayoutItem::ComponentLookup lookup (owningComponent);
+    root.realize (state, owningComponent, this, lookup);
+    plan->endNodeChanges();
+    unresolvedComponents = lookup.unresolved;
+    if (!plan->isCompiled() || plan->getNode (0) != state) {
+        plan->compile (state);
+    }
 }
 
 void Layout::updateGeometry ()
 {
-    if (state.isValid()) {
-        LayoutItem root (state);
-        juce::Rectangle<int> bounds = root.getItemBounds();
-        if (bounds.isEmpty() && owningComponent) {
-            bounds = owningComponent->getLocalBounds();
+    if (batchDepth > 0) {
+        // performed once in endUpdate
+        batchChanged = true;
+        return;
+    }
+    if (updateAsynchronously || useScheduler) {
+        triggerUpdate();
+        return;
+    }
+    if (isUpdatePending()) {
+        // the scheduled pass would compute the same again
+        cancelPendingUpdate();
+        ++coalescedUpdates;
+    }
+    performUpdate();
+}
+
+void Layout::performUpdate ()
+{
+    juce::Rectangle<int> bounds, padded;
+    if (getLayoutBounds (bounds, padded)) {
+        if (!padded.isEmpty()) {
+            if (!plan->isCompiled() && !plan->isUpdatingGeometry()) {
+                plan->compile (state);
+            }
+            plan->computeGeometry (padded);
+            commitGeometry();
+        }
+        finishUpdate (bounds);
+    }
+}
+
+bool Layout::performScheduledUpdate (double deadline, int sliceSize)
+{
+    if (plan->isSlicedGeometryPending()) {
+        // the pass was started with outdated input, so start over
+        juce::Rectangle<int> bounds, padded;
+        if (!plan->isCompiled() || !getLayoutBounds (bounds, padded) || bounds != slicedBounds) {
+            plan->cancelSlicedGeometry();
+        }
+    }
+    if (!plan->isSlicedGeometryPending()) {
+        juce::Rectangle<int> bounds, padded;
+        if (!getLayoutBounds (bounds, padded)) {
+            return true;
+        }
+        if (!plan->isCompiled() && !plan->isUpdatingGeometry()) {
+            plan->compile (state);
         }
+        if (padded.isEmpty() || sliceSize <= 0 || plan->getNumNodes() <= sliceSize) {
+            performUpdate();
+            return true;
+        }
+        plan->beginSlicedGeometry (padded, sliceSize);
+        slicedBounds = bounds;
+    }
+    if (!plan->continueSlicedGeometry (deadline)) {
+        return false;
+    }
+    commitGeometry();
+    finishUpdate (slicedBounds);
+    return true;
+}
+
+bool Layout::getLayoutBounds (juce::Rectangle<int>& bounds, juce::Rectangle<int>& padded) const
+{
+    if (!state.isValid()) {
+        return false;
+    }
+    LayoutItem root (state);
+    bounds = root.getItemBounds();
+    if (bounds.isEmpty() && owningComponent) {
+        bounds = owningComponent->getLocalBounds();
+    }
+    if (bounds.isEmpty()) {
+        return false;
+    }
+    const int shrinkX = root.getPaddingLeft() + root.getPaddingRight();
+    const int shrinkY = root.getPaddingTop() + root.getPaddingBottom();
+    padded = juce::Rectangle<int>();
+    if (bounds.getWidth() > shrinkX && bounds.getHeight() > shrinkY) {
+        padded.setBounds (bounds.getX() + root.getPaddingLeft(),
+                          bounds.getY() + root.getPaddingRight(),
+                          bounds.getWidth() - shrinkX,
+                          bounds.getHeight() - shrinkY);
+    }
+    return true;
+}
+
+void Layout::finishUpdate (juce::Rectangle<int> bounds)
+{
+    if (resizer) {
+        resizer->setBounds(bounds.getRight() - resizer->getWidth(), bounds.getBottom() - resizer->getHeight(), resizer->getWidth(), resizer->getHeight());
+    }
+    LayoutItem root (state);
+    root.callListenersCallback (bounds);
+}
+
+void Layout::updateGeometry (juce::ValueTree node)
+{
+    if (batchDepth > 0) {
+        batchChanged = true;
+        return;
+    }
+    if (updateAsynchronously || useScheduler) {
+        triggerUpdate();
+        return;
+    }
+    const int index = plan->isCompiled() ? plan->getIndexOfNode (node) : -1;
+    if (index > 0) {
+        // the node gets the same bounds from it's parent, so only the node itself needs to be computed
+        const juce::Rectangle<int> bounds = plan->getInputBounds (index);
         if (!bounds.isEmpty()) {
-            const int shrinkX = root.getPaddingLeft() + root.getPaddingRight();
-            const int shrinkY = root.getPaddingTop() + root.getPaddingBottom();
-            if (bounds.getWidth() > shrinkX && bounds.getHeight() > shrinkY) {
-                juce::Rectangle<int> padded (bounds.getX() + root.getPaddingLeft(),
-                                             bounds.getY() + root.getPaddingRight(),
-                                             bounds.getWidth() - shrinkX,
-                                             bounds.getHeight() - shrinkY);
-                LayoutItem::updateGeometry (state, padded);
-            }
-            if (resizer) {
-                resizer->setBounds(bounds.getRight() - resizer->getWidth(), bounds.getBottom() - resizer->getHeight(), resizer->getWidth(), resizer->getHeight());
-            }
-            root.callListenersCallback (bounds);
+            plan->computeNodeGeometry (index, bounds);
+            commitGeometry();
+            return;
+        }
+    }
+    updateGeometry();
+}
+
+void Layout::moveSplitter (juce::ValueTree splitterNode, float position, bool final)
+{
+    {
+        // the targeted update below covers this change
+        juce::ScopedValueSetter<bool> ignore (ignoreStateChanges, true);
+        LayoutSplitter splitter (splitterNode);
+        splitter.setRelativePosition (position);
+    }
+    updateGeometry (splitterNode.getParent());
+    if (final) {
+        storeSplitterPosition (splitterNode);
+    }
+}
+
+void Layout::storeSplitterPosition (juce::ValueTree splitterNode)
+{
+    LayoutSplitter splitter (splitterNode);
+    const float position = splitter.getRelativePosition();
+    if (position != static_cast<float> (splitterNode.getProperty (LayoutSplitter::propRelativePosition, 0.5))) {
+        // the plan already uses this position, no update needed
+        juce::ScopedValueSetter<bool> ignore (ignoreStateChanges, true);
+        splitter.setRelativePosition (position);
+    }
+}
+
+void Layout::triggerUpdate ()
+{
+    if (useScheduler) {
+        if (!LayoutScheduler::getInstance()->schedule (this)) {
+            ++coalescedUpdates;
         }
+        return;
+    }
+    if (isUpdatePending()) {
+        ++coalescedUpdates;
+        return;
+    }
+    triggerAsyncUpdate();
+}
+
+void Layout::flush ()
+{
+    LayoutScheduler* scheduler = LayoutScheduler::getInstanceWithoutCreating();
+    if (scheduler && scheduler->remove (this)) {
+        // completes a sliced pass as well
+        performUpdate();
+    }
+    handleUpdateNowIfNeeded();
+}
+
+void Layout::handleAsyncUpdate ()
+{
+    performUpdate();
+}
+
+void Layout::setUpdatesAsynchronously (bool shouldUpdateAsynchronously)
+{
+    updateAsynchronously = shouldUpdateAsynchronously;
+    if (!updateAsynchronously) {
+        flush();
+    }
+}
+
+bool Layout::isUpdatingAsynchronously () const
+{
+    return updateAsynchronously;
+}
+
+void Layout::setUpdatesOnStateChange (bool shouldUpdateOnStateChange)
+{
+    updateOnStateChange = shouldUpdateOnStateChange;
+}
+
+bool Layout::isUpdatingOnStateChange () const
+{
+    return updateOnStateChange;
+}
+
+void Layout::beginUpdate ()
+{
+    ++batchDepth;
+}
+
+void Layout::endUpdate ()
+{
+    jassert (batchDepth > 0);
+    if (batchDepth > 0 && --batchDepth == 0 && batchChanged) {
+        batchChanged = false;
+        updateGeometry();
+    }
+}
+
+void Layout::stateChanged ()
+{
+    // changes written during a pass are the result, not the cause of a relayout
+    if (!updateOnStateChange || ignoreStateChanges || plan->isUpdatingGeometry()) {
+        return;
+    }
+    if (batchDepth > 0) {
+        batchChanged = true;
     }
+    else {
+        triggerUpdate();
+    }
+}
+
+void Layout::setUsesScheduler (bool shouldUseScheduler, int priority)
+{
+    schedulingPriority = priority;
+    if (useScheduler != shouldUseScheduler) {
+        // don't lose an update, that is waiting in the other queue
+        flush();
+        useScheduler = shouldUseScheduler;
+    }
+}
+
+bool Layout::isUsingScheduler () const
+{
+    return useScheduler;
+}
+
+int Layout::getSchedulingPriority () const
+{
+    return schedulingPriority;
+}
+
+void Layout::commitGeometry ()
+{
+    // Component::setBounds repaints the moved components already
+    plan->commitGeometry();
+}
+
+void Layout::setParallelThreshold (int minNumNodes, int numThreads)
+{
+    plan->setParallelThreshold (minNumNodes, numThreads);
+}
+
+void Layout::setGeometryCacheSize (int numEntries)
+{
+    plan->setCacheSize (numEntries);
+}
+
+LayoutPlan::Statistics Layout::getStatistics () const
+{
+    LayoutPlan::Statistics statistics = plan->getStatistics();
+    statistics.coalescedUpdates = coalescedUpdates;
+    return statistics;
+}
+
+void Layout::resetStatistics ()
+{
+    plan->resetStatistics();
+    coalescedUpdates = 0;
 }
 
 void Layout::paintBounds (juce::Graphics& g) const
@@ -243,4 +685,50 @@ void Layout::paintBounds (juce::Graphics& g) const
 
 //==============================================================================
 
+void Layout::valueTreePropertyChanged (juce::ValueTree& treeWhosePropertyHasChanged, const juce::Identifier& property)
+{
+    if (property == LayoutItem::propComponentID) {
+        itemIndexValid = false;
+    }
+    if (!LayoutPlan::isComputedProperty (property)) {
+        plan->nodeChanged (treeWhosePropertyHasChanged);
+        stateChanged();
+    }
+}
+
+void Layout::valueTreeChildAdded (juce::ValueTree& parentTree, juce::ValueTree&)
+{
+    itemIndexValid = false;
+    plan->invalidate();
+    plan->markDirty (parentTree);
+    stateChanged();
+}
+
+void Layout::valueTreeChildRemoved (juce::ValueTree& parentTree, juce::ValueTree&, int)
+{
+    itemIndexValid = false;
+    plan->invalidate();
+    plan->markDirty (parentTree);
+    stateChanged();
+}
+
+void Layout::valueTreeChildOrderChanged (juce::ValueTree& parentTree, int, int)
+{
+    itemIndexValid = false;
+    plan->invalidate();
+    plan->markDirty (parentTree);
+    stateChanged();
+}
+
+void Layout::valueTreeParentChanged (juce::ValueTree&)
+{
+}
+
+void Layout::valueTreeRedirected (juce::ValueTree&)
+{
+    itemIndexValid = false;
+    plan->invalidate();
+    stateChanged();
+}
+
 
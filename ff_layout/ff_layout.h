@@ -82,5 +82,26 @@
  */
 
 
+//==============================================================================
+/** Config: FF_LAYOUT_BENCHMARKS
+    Adds juce::UnitTests in the category "ffLayout benchmarks", that time the layout
+    passes and reading the xml of a large generated layout and write the numbers to
+    the log. Run them with a juce::UnitTestRunner, e.g. LayoutEditor --benchmark
+*/
+#ifndef FF_LAYOUT_BENCHMARKS
+ #define FF_LAYOUT_BENCHMARKS 0
+#endif
+
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <unordered_map>
+
 #include "ff_layoutCore.h"
 #include "ff_layoutItem.h"
+#include "ff_layoutPlan.h"
+#include "ff_layoutScheduler.h"
+#include "ff_layoutBuilder.h"
+#include "ff_layoutXmlReader.h"
+#include "ff_layoutDefinitionCache.h"
+#include "ff_layoutLoader.h"
@@ -0,0 +1,165 @@
+/*
+  ==============================================================================
+
+  Copyright (c) 2016 - 2017, Daniel Walz
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without modification,
+  are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+     list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors
+     may be used to endorse or promote products derived from this software without
+     specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+  INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+  OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+  OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    ff_layoutBenchmarks.cpp
+    Created: 18 Oct 2026 9:14:05am
+
+  ==============================================================================
+*/
+
+
+#include "ff_layout.h"
+
+#if FF_LAYOUT_BENCHMARKS
+
+/**
+ Creates a layout of numColumns columns with numRows rows of numItems spacers
+ each, so a pass has many independent sub layouts of the same size.
+ */
+static juce::ValueTree createBenchmarkLayout (int numColumns, int numRows, int numItems)
+{
+    LayoutBuilder builder (LayoutItem::LeftToRight);
+    for (int column=0; column < numColumns; ++column) {
+        builder.beginSubLayout (LayoutItem::TopDown);
+        for (int row=0; row < numRows; ++row) {
+            builder.beginSubLayout (LayoutItem::LeftToRight);
+            for (int item=0; item < numItems; ++item) {
+                builder.addSpacer();
+            }
+            builder.endSubLayout();
+        }
+        builder.endSubLayout();
+    }
+    return builder.getTree();
+}
+
+//==============================================================================
+/**
+ Times a full pass of a large generated layout on the calling thread and with
+ 1..N worker threads of the shared pool, and checks the results are identical.
+ The times are written to the log, run it e.g. with LayoutEditor --benchmark.
+ */
+class LayoutParallelBenchmark : public juce::UnitTest
+{
+public:
+    LayoutParallelBenchmark () : juce::UnitTest ("Layout parallel passes", "ffLayout benchmarks") {}
+
+    void runTest () override
+    {
+        const juce::ValueTree tree = createBenchmarkLayout (64, 64, 4);
+
+        beginTest ("serial");
+        LayoutPlan serial;
+        serial.compile (tree, LayoutPlan::Detached);
+        const double serialTime = timePasses (serial);
+        logMessage (juce::String (serial.getNumNodes()) + " nodes, serial: " + juce::String (serialTime, 3) + " ms per pass");
+
+        const int maxThreads = juce::jmax (1, juce::SystemStats::getNumCpus() - 1);
+        for (int numThreads=1; numThreads <= maxThreads; ++numThreads) {
+            beginTest (juce::String (numThreads) + " worker threads");
+            LayoutPlan parallel;
+            parallel.compile (tree, LayoutPlan::Detached);
+            parallel.setParallelThreshold (1, numThreads);
+            const double time = timePasses (parallel);
+            logMessage (juce::String (numThreads) + " worker threads: " + juce::String (time, 3) + " ms per pass, "
+                        + juce::String (serialTime / time, 2) + "x");
+
+            bool identical = true;
+            for (int i=0; i < serial.getNumNodes() && identical; ++i) {
+                identical = parallel.getItemBounds (i) == serial.getItemBounds (i);
+            }
+            expect (identical, "the parallel pass computed different bounds");
+        }
+    }
+
+private:
+    /** Returns the average time of a pass in milliseconds */
+    static double timePasses (LayoutPlan& plan)
+    {
+        // every column and row changes size, so no sub layout is skipped
+        const int numPasses = 50;
+        plan.computeGeometry (juce::Rectangle<int> (0, 0, 2000, 1000));
+        const double start = juce::Time::getMillisecondCounterHiRes();
+        for (int i=0; i < numPasses; ++i) {
+            const int grow = (i % 2 == 0) ? 256 : 0;
+            plan.computeGeometry (juce::Rectangle<int> (0, 0, 2000 + grow, 1000 + grow));
+        }
+        return (juce::Time::getMillisecondCounterHiRes() - start) / numPasses;
+    }
+};
+
+static LayoutParallelBenchmark layoutParallelBenchmark;
+
+//==============================================================================
+/**
+ Times reading a large generated layout xml with the LayoutXmlReader against
+ juce::XmlDocument::parse followed by juce::ValueTree::fromXml, and checks both
+ create the same tree.
+ */
+class LayoutXmlReaderBenchmark : public juce::UnitTest
+{
+public:
+    LayoutXmlReaderBenchmark () : juce::UnitTest ("Layout xml reader", "ffLayout benchmarks") {}
+
+    void runTest () override
+    {
+        const juce::String xml = createBenchmarkLayout (64, 64, 4).toXmlString();
+        const int numRuns = 20;
+
+        beginTest ("XmlDocument and ValueTree::fromXml");
+        juce::ValueTree reference;
+        double start = juce::Time::getMillisecondCounterHiRes();
+        for (int i=0; i < numRuns; ++i) {
+            std::unique_ptr<juce::XmlElement> element (juce::XmlDocument::parse (xml));
+            reference = juce::ValueTree::fromXml (*element);
+        }
+        const double documentTime = (juce::Time::getMillisecondCounterHiRes() - start) / numRuns;
+        logMessage (juce::String (xml.length()) + " characters, XmlDocument: " + juce::String (documentTime, 3) + " ms");
+
+        beginTest ("LayoutXmlReader");
+        juce::ValueTree tree;
+        start = juce::Time::getMillisecondCounterHiRes();
+        for (int i=0; i < numRuns; ++i) {
+            tree = LayoutXmlReader::parse (xml);
+        }
+        const double readerTime = (juce::Time::getMillisecondCounterHiRes() - start) / numRuns;
+        logMessage ("LayoutXmlReader: " + juce::String (readerTime, 3) + " ms, "
+                    + juce::String (documentTime / readerTime, 2) + "x");
+
+        expect (tree.isEquivalentTo (reference), "the reader created a different tree");
+    }
+};
+
+static LayoutXmlReaderBenchmark layoutXmlReaderBenchmark;
+
+#endif // FF_LAYOUT_BENCHMARKS
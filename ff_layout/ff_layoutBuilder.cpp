@@ -0,0 +1,125 @@
+/*
+  ==============================================================================
+
+  Copyright (c) 2016 - 2017, Daniel Walz
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without modification,
+  are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+     list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors
+     may be used to endorse or promote products derived from this software without
+     specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+  INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+  OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+  OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    ff_layoutBuilder.cpp
+    Created: 18 Oct 2026 8:12:05am
+
+  ==============================================================================
+*/
+
+
+#include "ff_layout.h"
+
+LayoutBuilder::LayoutBuilder (LayoutItem::Orientation orientation)
+{
+    root = LayoutItem (orientation).state;
+    openSubLayouts.add (root);
+}
+
+LayoutBuilder::~LayoutBuilder ()
+{
+}
+
+LayoutItem LayoutBuilder::addComponent (juce::Component* component, bool owned)
+{
+    // the node is detached, so the make methods don't notify anybody
+    juce::ValueTree parent = openSubLayouts.getLast();
+    return LayoutItem::makeChildComponent (parent, component, owned);
+}
+
+LayoutItem LayoutBuilder::addLabeledComponent (juce::Component* component, const juce::String& text, LayoutItem::Orientation o, bool owned)
+{
+    juce::ValueTree parent = openSubLayouts.getLast();
+    return LayoutItem::makeLabeledChildComponent (parent, component, text, o, owned);
+}
+
+LayoutSplitter LayoutBuilder::addSplitter (float position)
+{
+    juce::ValueTree parent = openSubLayouts.getLast();
+    return LayoutItem::makeChildSplitter (parent, position);
+}
+
+LayoutItem LayoutBuilder::addSpacer (float stretchX, float stretchY)
+{
+    juce::ValueTree parent = openSubLayouts.getLast();
+    return LayoutItem::makeChildSpacer (parent, stretchX, stretchY);
+}
+
+LayoutItem LayoutBuilder::beginSubLayout (LayoutItem::Orientation orientation)
+{
+    juce::ValueTree parent = openSubLayouts.getLast();
+    LayoutItem sub = LayoutItem::makeSubLayout (parent, orientation);
+    openSubLayouts.add (sub.state);
+    return sub;
+}
+
+void LayoutBuilder::endSubLayout ()
+{
+    // more endSubLayout than beginSubLayout calls
+    jassert (openSubLayouts.size() > 1);
+    if (openSubLayouts.size() > 1) {
+        openSubLayouts.removeLast();
+    }
+}
+
+LayoutItem LayoutBuilder::getCurrentSubLayout () const
+{
+    return LayoutItem (openSubLayouts.getLast());
+}
+
+juce::ValueTree LayoutBuilder::getTree () const
+{
+    return root;
+}
+
+LayoutItem LayoutBuilder::attachTo (juce::ValueTree& parent, int idx, juce::UndoManager* undo)
+{
+    // a sub layout was not closed
+    jassert (openSubLayouts.size() == 1);
+
+    juce::ValueTree built = root;
+    LayoutItem item (built);
+    if (undo) undo->beginNewTransaction (TRANS ("Add layout items"));
+    parent.addChild (built, idx, undo);
+
+    // further items must not end up in the attached tree, that would notify each time
+    root = LayoutItem (item.getOrientation()).state;
+    openSubLayouts.clearQuick();
+    openSubLayouts.add (root);
+    return item;
+}
+
+LayoutItem LayoutBuilder::attachTo (Layout& layout, int idx, juce::UndoManager* undo)
+{
+    return attachTo (layout.state, idx, undo);
+}
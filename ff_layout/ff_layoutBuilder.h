@@ -0,0 +1,117 @@
+/*
+  ==============================================================================
+
+  Copyright (c) 2016 - 2017, Daniel Walz
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without modification,
+  are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+     list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors
+     may be used to endorse or promote products derived from this software without
+     specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+  INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+  OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+  OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    ff_layoutBuilder.h
+    Created: 18 Oct 2026 8:12:05am
+
+  ==============================================================================
+*/
+
+#pragma once
+
+
+class Layout;
+
+//==============================================================================
+/**
+ The LayoutBuilder assembles a sub layout in a detached ValueTree, so adding the
+ items and setting their properties doesn't notify any listener. When it is done,
+ attachTo adds the whole subtree with a single addChild, which is one undo
+ transaction and, if the Layout updates on state changes, triggers one relayout.
+
+ \code{.cpp}
+ LayoutBuilder builder (LayoutItem::LeftToRight);
+ for (int i=0; i < strips.size(); ++i) {
+     builder.beginSubLayout (LayoutItem::TopDown);
+     builder.addComponent (strips[i]->fader);
+     builder.addLabeledComponent (strips[i]->pan, "Pan");
+     builder.endSubLayout();
+ }
+ builder.attachTo (myLayout);
+ \endcode
+
+ @see LayoutItem::makeChildComponent
+ */
+class LayoutBuilder
+{
+public:
+    /** Start building a sub layout with the given orientation */
+    LayoutBuilder (LayoutItem::Orientation orientation);
+    ~LayoutBuilder ();
+
+    /** Add a component item to the current sub layout @see LayoutItem::makeChildComponent */
+    LayoutItem addComponent (juce::Component* component, bool owned=false);
+
+    /** Add a component with a label to the current sub layout @see LayoutItem::makeLabeledChildComponent */
+    LayoutItem addLabeledComponent (juce::Component* component, const juce::String& text,
+                                    LayoutItem::Orientation o=LayoutItem::TopDown, bool owned=false);
+
+    /** Add a splitter to the current sub layout @see LayoutItem::makeChildSplitter */
+    LayoutSplitter addSplitter (float position);
+
+    /** Add a spacer to the current sub layout @see LayoutItem::makeChildSpacer */
+    LayoutItem addSpacer (float stretchX=1.0, float stretchY=1.0);
+
+    /**
+     Add a sub layout to the current sub layout. The following items are added to
+     the new sub layout until endSubLayout is called.
+     */
+    LayoutItem beginSubLayout (LayoutItem::Orientation orientation);
+
+    /** Continue adding items to the parent of the current sub layout */
+    void endSubLayout ();
+
+    /** Returns the sub layout, the items are currently added to */
+    LayoutItem getCurrentSubLayout () const;
+
+    /** Returns the root of the built subtree */
+    juce::ValueTree getTree () const;
+
+    /**
+     Add the built subtree to parent with a single addChild in one undo transaction.
+     The builder starts over with an empty sub layout afterwards.
+     @param parent the node in the hierarchical layout structure
+     @param idx the position in the sequence of already present nodes. If -1 the item is appended at the end
+     @param undo the UndoManager for the ValueTree, so changes can be rolled back
+     */
+    LayoutItem attachTo (juce::ValueTree& parent, int idx=-1, juce::UndoManager* undo=nullptr);
+
+    /** Add the built subtree to the root of a layout @see attachTo */
+    LayoutItem attachTo (Layout& layout, int idx=-1, juce::UndoManager* undo=nullptr);
+
+private:
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LayoutBuilder)
+
+    juce::ValueTree                 root;
+    juce::Array<juce::ValueTree>    openSubLayouts;
+};
@@ -41,6 +41,9 @@
 
 
 #include "ff_layoutItem.h"
+#include "ff_layoutPlan.h"
+
+class PreparedLayout;
 
 //==============================================================================
 /**
@@ -86,7 +89,9 @@
  @see LayoutItem
  */
 
-class Layout : public LayoutItemListener
+class Layout : public LayoutItemListener,
+               public juce::ValueTree::Listener,
+               private juce::AsyncUpdater
 {
 public:
     
@@ -124,6 +129,8 @@ public:
      \li \p relativePosition: The position in normalized form where the splitter is initially set
      \li \p relativeMaxPosition: the maximum normalized position to where the splitter can be moved
      \li \p relativeMinPosition: the minimum normalized position to where the splitter can be moved
+     \li \p coalesceDragging: set this to 1 to update the layout at most once per frame while dragging
+     \li \p outlineDragging: set this to 1 to drag only an outline and update the layout when the mouse is released
      
      The Layout has the following properties:
      \li \p orientation: the direction in which the items are laid out. Possible values are: \p leftToRight, \p topDown, \p rightToLeft and \p bottomUp
@@ -141,12 +148,29 @@ public:
      \li \p minHeight: the height the component shall not shrink below
      \li \p maxHeight: the maximum height the component may occupy
      
+     Recently used xml is parsed only once, the LayoutDefinitionCache keeps the
+     parsed tree. Each layout still gets it's own copy of it.
      */
     
     Layout (LayoutItem::Orientation o, juce::Component* owner=nullptr);
     Layout (const juce::String& xml, juce::Component* owner=nullptr);
     Layout (const juce::ValueTree& state, juce::Component* owner=nullptr);
 
+    /**
+     Create a layout from the binary layout format, e.g. from BinaryData. This
+     skips parsing the xml, the tree is read directly from the data.
+     @see writeBinaryLayout, convertXmlToBinary
+     */
+    Layout (const void* data, size_t size, juce::Component* owner=nullptr);
+
+    /**
+     Create a layout from a definition, that was parsed and compiled on a background
+     thread by the LayoutLoader. The layout takes over the tree and the compiled
+     plan, so only realize runs on the message thread.
+     @see LayoutLoader::loadAsync
+     */
+    Layout (PreparedLayout& prepared, juce::Component* owner=nullptr);
+
     ~Layout ();
     
     /**
@@ -166,6 +190,12 @@ public:
      Layout, an invalid ValueTree node is returned.
      */
     juce::ValueTree getLayoutItem (juce::Component*);
+
+    /**
+     Retrieve the LayoutItem for a componentID. If no item with that componentID is
+     found in the Layout, an invalid ValueTree node is returned.
+     */
+    juce::ValueTree getLayoutItem (const juce::String& componentID);
     
     /**
      Call this to connect a fresh state to the owningComponent. In this step layout defined 
@@ -174,6 +204,18 @@ public:
      componentName.
      */
     void realize (juce::Component* owningComponent=nullptr);
+
+    /**
+     Returns the componentIDs and componentNames, that could not be found as children
+     of the owningComponent in the last call to realize.
+     */
+    const juce::StringArray& getUnresolvedComponents() const;
+
+    /**
+     Returns why the xml given to the constructor could not be read, with the line
+     and column, where it is malformed. Empty, if it was read successfully.
+     */
+    const juce::String& getLoadError() const;
     
     /**
      Call this method in your Component::resized() callback.
@@ -182,6 +224,139 @@ public:
      */
     void updateGeometry ();
 
+    /**
+     Recompute only the sub layout node, using the bounds it got in the last pass.
+     Use this, if a change can only affect the items inside node, e.g. when a
+     splitter in node was moved. If node wasn't laid out yet, the whole layout is
+     updated. In asynchronous mode this schedules an update of the whole layout,
+     unchanged sub layouts are skipped anyway.
+     */
+    void updateGeometry (juce::ValueTree node);
+
+    /**
+     Set the position of a splitter and update only the sub layout it is in. The
+     change of the position property doesn't trigger another update. If final is
+     set, the position is stored like storeSplitterPosition does.
+     */
+    void moveSplitter (juce::ValueTree splitterNode, float position, bool final=false);
+
+    /**
+     The last pass might have moved the splitter to respect the size limits of the
+     neighbouring items. This writes that position back into the splitter's node,
+     so the node and the layout agree again. Called when a drag finishes.
+     */
+    void storeSplitterPosition (juce::ValueTree splitterNode);
+
+    /**
+     Schedule an update of the whole layout on the next message loop iteration,
+     or in the next frame of the LayoutScheduler.
+     Calling it again before the update was performed doesn't add another pass,
+     the skipped passes are counted as coalescedUpdates in the statistics.
+     */
+    void triggerUpdate ();
+
+    /**
+     Perform a scheduled update now, if there is one. Call this if you need the
+     bounds of the components to be set synchronously.
+     */
+    void flush ();
+
+    /**
+     In asynchronous mode the calls to updateGeometry, e.g. from resized, from
+     dragging a splitter or from setSettingsTree only schedule one update via
+     triggerUpdate. The default is synchronous.
+     */
+    void setUpdatesAsynchronously (bool shouldUpdateAsynchronously);
+
+    /** Returns true, if updateGeometry only schedules an update @see setUpdatesAsynchronously */
+    bool isUpdatingAsynchronously () const;
+
+    /**
+     Let the process wide LayoutScheduler perform the updates. Like in asynchronous
+     mode, updateGeometry only schedules an update, which the scheduler performs
+     in one of the next frames. Visible layouts are updated first, then the ones
+     with a higher priority.
+     @see LayoutScheduler
+     */
+    void setUsesScheduler (bool shouldUseScheduler, int priority=0);
+
+    /** Returns true, if the updates are performed by the LayoutScheduler */
+    bool isUsingScheduler () const;
+
+    /** Returns the priority, the LayoutScheduler orders the layouts by */
+    int getSchedulingPriority () const;
+
+    /**
+     When the state is changed, e.g. by LayoutItem::setStretch or by adding an
+     item, the layout triggers an update by itself, so there is no need to call
+     updateGeometry after each change. This is off by default, so existing code
+     calling updateGeometry itself doesn't get additional passes.
+     @see triggerUpdate
+     */
+    void setUpdatesOnStateChange (bool shouldUpdateOnStateChange);
+
+    /** Returns true, if a change to the state triggers an update */
+    bool isUpdatingOnStateChange () const;
+
+    /**
+     Start a batch of changes. Until the matching endUpdate, calls to updateGeometry
+     and, if setUpdatesOnStateChange is on, changes to the state are collected and
+     performed as one update in endUpdate. Calls can be nested.
+     @see ScopedBatch
+     */
+    void beginUpdate ();
+
+    /** End a batch started with beginUpdate and perform the update, if anything has changed */
+    void endUpdate ();
+
+    /**
+     Calls beginUpdate in the constructor and endUpdate in the destructor:
+     \code{.cpp}
+     {
+         Layout::ScopedBatch batch (myLayout);
+         for (int i=0; i < myLayout.state.getNumChildren(); ++i)
+             LayoutItem (myLayout.state.getChild (i)).setStretch (1.0f, 1.0f);
+     }   // one update here
+     \endcode
+     */
+    class ScopedBatch
+    {
+    public:
+        ScopedBatch (Layout& layoutToBatch) : layout (layoutToBatch) { layout.beginUpdate(); }
+        ~ScopedBatch () { layout.endUpdate(); }
+
+    private:
+        Layout& layout;
+        JUCE_DECLARE_NON_COPYABLE (ScopedBatch)
+    };
+
+    /**
+     Compute independent sub layouts on the shared thread pool, if the layout has
+     at least minNumNodes items. The bounds are still applied to the components on
+     the calling thread. Set minNumNodes to 0 to switch it off, which is the
+     default. Measure the benefit for your layout before enabling it.
+     @see LayoutPlan::setParallelThreshold
+     */
+    void setParallelThreshold (int minNumNodes, int numThreads=0);
+
+    /**
+     Keep the computed geometry of the last numEntries sizes, e.g. when a window
+     is toggled between a few sizes. The cache is dropped on any change to the
+     layout tree. Set 0 to switch it off, which is the default.
+     @see LayoutPlan::setCacheSize
+     */
+    void setGeometryCacheSize (int numEntries);
+
+    /**
+     Returns counters, how many component bounds and listener notifications were
+     applied and how many were skipped, because the item's geometry was unchanged.
+     Also counts the updates, that were coalesced by triggerUpdate.
+     */
+    LayoutPlan::Statistics getStatistics () const;
+
+    /** Reset the counters returned by getStatistics */
+    void resetStatistics ();
+
     /**
      To show the layout bounds e.g. for debugging yout layout structure simply add the following line to yout Component:
      \code{.cpp}
@@ -206,7 +381,44 @@ public:
 
     /** This is the callback to track resizer settings */
     void layoutSplitterMoved (juce::ValueTree item, float relativePos, bool final) override;
+
+    /** @internal */
+    void valueTreePropertyChanged (juce::ValueTree& treeWhosePropertyHasChanged, const juce::Identifier& property) override;
+    /** @internal */
+    void valueTreeChildAdded (juce::ValueTree& parentTree, juce::ValueTree& childWhichHasBeenAdded) override;
+    /** @internal */
+    void valueTreeChildRemoved (juce::ValueTree& parentTree, juce::ValueTree& childWhichHasBeenRemoved, int indexFromWhichChildWasRemoved) override;
+    /** @internal */
+    void valueTreeChildOrderChanged (juce::ValueTree& parentTreeWhoseChildrenHaveMoved, int oldIndex, int newIndex) override;
+    /** @internal */
+    void valueTreeParentChanged (juce::ValueTree& treeWhoseParentHasChanged) override;
+    /** @internal */
+    void valueTreeRedirected (juce::ValueTree& treeWhichHasBeenChanged) override;
     
+    /**
+     Write a layout tree in the binary layout format. The format is a short header
+     with a magic number and a version, followed by the tree as written by
+     juce::ValueTree::writeToStream. The volatile properties are left out.
+     */
+    static void writeBinaryLayout (const juce::ValueTree& state, juce::OutputStream& output);
+
+    /**
+     Convert a layout xml into the binary layout format, e.g. at build time.
+     Returns false, if the xml could not be parsed, and sets errorMessage to the
+     line, column and reason.
+     @see LayoutXmlReader
+     */
+    static bool convertXmlToBinary (const juce::String& xml, juce::OutputStream& output, juce::String* errorMessage=nullptr);
+
+    /**
+     Read a tree written by writeBinaryLayout. Returns an invalid tree, if the data
+     is not a binary layout or was written by a newer version.
+     */
+    static juce::ValueTree readBinaryLayout (const void* data, size_t size);
+
+    /** Returns true, if the data starts with the header of the binary layout format */
+    static bool isBinaryLayout (const void* data, size_t size);
+
     /** Use the state to identify nodes in the hierarchy where to add layout items */
     juce::ValueTree state;
     
@@ -228,12 +440,16 @@ public:
     static const juce::Identifier settingsHeight;
     static const juce::Identifier settingsSplittersList;
     static const juce::Identifier settingsSplitterPos;
+
+    static const juce::uint32 binaryLayoutMagic;
+    static const int          binaryLayoutVersion;
     
 private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Layout)
     
     juce::WeakReference<Layout>::Master masterReference;
     friend class juce::WeakReference<Layout>;
+    friend class LayoutScheduler;
     
     juce::Component::SafePointer<juce::Component> owningComponent;
     
@@ -243,8 +459,70 @@ private:
      */
     juce::ValueTree currentSettings;
     
+    juce::StringArray                                   unresolvedComponents;
+    juce::String                                        loadError;
+
     std::unique_ptr<juce::ResizableCornerComponent>     resizer;
     std::unique_ptr<juce::ComponentBoundsConstrainer>   resizeConstraints;
 
+    /** @internal */
+    static void removeVolatileProperties (juce::ValueTree& node);
+
+    /** @internal */
+    void stateChanged ();
+
+    /** @internal */
+    void performUpdate ();
+
+    /** @internal */
+    bool performScheduledUpdate (double deadline, int sliceSize);
+
+    /** @internal */
+    bool getLayoutBounds (juce::Rectangle<int>& bounds, juce::Rectangle<int>& padded) const;
+
+    /** @internal */
+    void finishUpdate (juce::Rectangle<int> bounds);
+
+    /** @internal */
+    void commitGeometry ();
+
+    /** @internal */
+    void handleAsyncUpdate () override;
+
+    /** @internal */
+    void buildItemIndex ();
+
+    /** @internal */
+    void addToItemIndex (const juce::ValueTree& node);
+
+    /** @internal */
+    bool isInLayout (const juce::ValueTree& node) const;
+
+    /**
+     Lookup tables from components and componentIDs to their items, so the splitters
+     can find their node on each mouse move. They are rebuilt, when the structure
+     of state was changed or a lookup found a stale entry.
+     */
+    std::unordered_map<juce::Component*, juce::ValueTree> componentIndex;
+    juce::HashMap<juce::String, juce::ValueTree>           componentIDIndex;
+    bool                                                   itemIndexValid = false;
+
+    bool                                                   updateAsynchronously = false;
+    bool                                                   useScheduler = false;
+    int                                                    schedulingPriority = 0;
+    juce::Rectangle<int>                                   slicedBounds;
+    bool                                                   updateOnStateChange = false;
+    bool                                                   ignoreStateChanges = false;
+    int                                                    batchDepth = 0;
+    bool                                                   batchChanged = false;
+    juce::int64                                            coalescedUpdates = 0;
+
+    /**
+     The compiled form of state, which is used in updateGeometry. It is compiled
+     again on the next pass, when the state was changed. A plan compiled on a
+     background thread is taken over from a PreparedLayout.
+     */
+    std::unique_ptr<LayoutPlan> plan { new LayoutPlan() };
+
 
 };
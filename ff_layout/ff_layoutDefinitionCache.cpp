@@ -0,0 +1,193 @@
+/*
+  ==============================================================================
+
+  Copyright (c) 2016 - 2017, Daniel Walz
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without modification,
+  are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+     list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors
+     may be used to endorse or promote products derived from this software without
+     specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+  INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+  OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+  OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    ff_layoutDefinitionCache.cpp
+    Created: 18 Oct 2026 11:41:16am
+
+  ==============================================================================
+*/
+
+
+#include "ff_layout.h"
+
+JUCE_IMPLEMENT_SINGLETON (LayoutDefinitionCache)
+
+LayoutDefinitionCache::LayoutDefinitionCache ()
+  : maxNumDefinitions (16),
+    hits (0),
+    misses (0)
+{
+}
+
+LayoutDefinitionCache::~LayoutDefinitionCache ()
+{
+    clearSingletonInstance();
+}
+
+juce::ValueTree LayoutDefinitionCache::getLayoutFromXml (const juce::String& xml, juce::String* errorMessage)
+{
+    const size_t size = xml.getNumBytesAsUTF8();
+    const juce::int64 hash = hashData (xml.toRawUTF8(), size);
+
+    const juce::ValueTree definition = findDefinition (hash, xml.toRawUTF8(), size, false);
+    if (definition.isValid()) {
+        if (errorMessage) {
+            *errorMessage = juce::String();
+        }
+        // the cached tree is never handed out, so nobody can change it while copying
+        return definition.createCopy();
+    }
+
+    // parsing happens outside the lock, so other layouts are not blocked meanwhile
+    juce::ValueTree tree = LayoutXmlReader::parse (xml, errorMessage);
+    if (!tree.isValid()) {
+        return tree;
+    }
+    addDefinition (hash, xml.toRawUTF8(), size, false, tree);
+    return tree.createCopy();
+}
+
+juce::ValueTree LayoutDefinitionCache::getLayoutFromBinary (const void* data, size_t size)
+{
+    if (!Layout::isBinaryLayout (data, size)) {
+        return juce::ValueTree();
+    }
+    const juce::int64 hash = hashData (data, size);
+
+    const juce::ValueTree definition = findDefinition (hash, data, size, true);
+    if (definition.isValid()) {
+        return definition.createCopy();
+    }
+
+    juce::ValueTree tree = Layout::readBinaryLayout (data, size);
+    if (!tree.isValid()) {
+        return tree;
+    }
+    addDefinition (hash, data, size, true, tree);
+    return tree.createCopy();
+}
+
+void LayoutDefinitionCache::clear ()
+{
+    const juce::ScopedLock sl (lock);
+    definitions.clear();
+}
+
+void LayoutDefinitionCache::setMaxNumDefinitions (int maxNum)
+{
+    const juce::ScopedLock sl (lock);
+    maxNumDefinitions = juce::jmax (0, maxNum);
+    removeExcessDefinitions();
+}
+
+int LayoutDefinitionCache::getMaxNumDefinitions () const
+{
+    const juce::ScopedLock sl (lock);
+    return maxNumDefinitions;
+}
+
+int LayoutDefinitionCache::getNumDefinitions () const
+{
+    const juce::ScopedLock sl (lock);
+    return definitions.size();
+}
+
+juce::int64 LayoutDefinitionCache::getNumHits () const
+{
+    const juce::ScopedLock sl (lock);
+    return hits;
+}
+
+juce::int64 LayoutDefinitionCache::getNumMisses () const
+{
+    const juce::ScopedLock sl (lock);
+    return misses;
+}
+
+juce::int64 LayoutDefinitionCache::hashData (const void* data, size_t size)
+{
+    // 64 bit FNV-1a
+    const juce::uint8* bytes = static_cast<const juce::uint8*> (data);
+    juce::uint64 hash = 14695981039346656037ULL;
+    for (size_t i=0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return static_cast<juce::int64> (hash);
+}
+
+juce::ValueTree LayoutDefinitionCache::findDefinition (juce::int64 hash, const void* data, size_t size, bool binary)
+{
+    const juce::ScopedLock sl (lock);
+    for (int i=definitions.size() - 1; i >= 0; --i) {
+        const Definition* definition = definitions.getUnchecked (i);
+        if (definition->hash == hash
+            && definition->binary == binary
+            && definition->source.matches (data, size)) {
+            definitions.move (i, -1);
+            ++hits;
+            return definition->tree;
+        }
+    }
+    ++misses;
+    return juce::ValueTree();
+}
+
+void LayoutDefinitionCache::addDefinition (juce::int64 hash, const void* data, size_t size, bool binary, const juce::ValueTree& tree)
+{
+    // copying the source happens outside the lock as well
+    std::unique_ptr<Definition> definition (new Definition());
+    definition->hash = hash;
+    definition->binary = binary;
+    definition->source = juce::MemoryBlock (data, size);
+    definition->tree = tree;
+
+    const juce::ScopedLock sl (lock);
+    for (int i=0; i < definitions.size(); ++i) {
+        // another thread might have parsed the same data meanwhile
+        const Definition* existing = definitions.getUnchecked (i);
+        if (existing->hash == hash && existing->binary == binary && existing->source == definition->source) {
+            definitions.remove (i);
+            break;
+        }
+    }
+    definitions.add (definition.release());
+    removeExcessDefinitions();
+}
+
+void LayoutDefinitionCache::removeExcessDefinitions ()
+{
+    if (definitions.size() > maxNumDefinitions) {
+        definitions.removeRange (0, definitions.size() - maxNumDefinitions);
+    }
+}
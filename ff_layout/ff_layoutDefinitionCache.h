@@ -0,0 +1,130 @@
+/*
+  ==============================================================================
+
+  Copyright (c) 2016 - 2017, Daniel Walz
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without modification,
+  are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+     list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors
+     may be used to endorse or promote products derived from this software without
+     specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+  INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+  OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+  OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    ff_layoutDefinitionCache.h
+    Created: 18 Oct 2026 11:41:16am
+
+  ==============================================================================
+*/
+
+#pragma once
+
+
+//==============================================================================
+/**
+ The LayoutDefinitionCache is a parse cache for layout definitions. When several
+ editors are opened from the same BinaryData, only the first one parses it, the
+ others get a copy of the parsed tree. It saves the parsing, not the memory: each
+ Layout needs it's own copy, because each instance keeps it's component bindings,
+ splitter positions and computed bounds in it's own tree.
+
+ The cache keeps the most recently used definitions, up to a maximum number, so
+ an editor creating a layout for each edit doesn't fill it up. A definition is
+ only reused, if the source data is identical, not just the hash.
+
+ The Layout constructors taking xml or binary data use this cache.
+
+ @see LayoutXmlReader, Layout::readBinaryLayout
+ */
+class LayoutDefinitionCache : public juce::DeletedAtShutdown
+{
+public:
+    LayoutDefinitionCache ();
+    ~LayoutDefinitionCache ();
+
+    JUCE_DECLARE_SINGLETON (LayoutDefinitionCache, false)
+
+    /**
+     Returns a copy of the parsed layout xml, which is parsed only the first time.
+     If the xml is malformed, an invalid tree is returned and errorMessage is set.
+     */
+    juce::ValueTree getLayoutFromXml (const juce::String& xml, juce::String* errorMessage=nullptr);
+
+    /**
+     Returns a copy of a binary layout, which is read only the first time. Returns
+     an invalid tree, if the data is not a binary layout.
+     */
+    juce::ValueTree getLayoutFromBinary (const void* data, size_t size);
+
+    /** Forget all parsed definitions */
+    void clear ();
+
+    /**
+     Set how many definitions are kept. When a new definition exceeds this number,
+     the least recently used one is dropped. The default is 16, 0 disables the cache.
+     */
+    void setMaxNumDefinitions (int maxNum);
+
+    /** Returns the number of definitions kept @see setMaxNumDefinitions */
+    int getMaxNumDefinitions () const;
+
+    /** Returns the number of parsed definitions */
+    int getNumDefinitions () const;
+
+    /** Returns, how many layouts were created from the cache without parsing */
+    juce::int64 getNumHits () const;
+
+    /** Returns, how many layouts had to be parsed */
+    juce::int64 getNumMisses () const;
+
+    /** Returns a hash of the data, which is used to find a definition quickly */
+    static juce::int64 hashData (const void* data, size_t size);
+
+private:
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LayoutDefinitionCache)
+
+    struct Definition
+    {
+        Definition () : hash (0), binary (false) {}
+
+        juce::int64         hash;
+        bool                binary;
+        juce::MemoryBlock   source;
+        juce::ValueTree     tree;
+    };
+
+    /** @internal */
+    juce::ValueTree findDefinition (juce::int64 hash, const void* data, size_t size, bool binary);
+
+    /** @internal */
+    void addDefinition (juce::int64 hash, const void* data, size_t size, bool binary, const juce::ValueTree& tree);
+
+    /** @internal */
+    void removeExcessDefinitions ();
+
+    juce::CriticalSection                       lock;
+    juce::OwnedArray<Definition>                definitions;    // least recently used first
+    int                                         maxNumDefinitions;
+    juce::int64                                 hits;
+    juce::int64                                 misses;
+};
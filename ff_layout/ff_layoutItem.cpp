@@ -86,7 +86,6 @@ const juce::Identifier LayoutItem::propGroupJustification   ("groupJustification
 const juce::Identifier LayoutItem::volatileSharedLayoutData ("volatileSharedLayoutData");
 const juce::Identifier LayoutItem::volatileItemBounds       ("volatileItemBounds");
 const juce::Identifier LayoutItem::volatileItemBoundsFixed  ("volatileItemBoundsFixed");
-const juce::Identifier LayoutItem::volatileIsUpdating       ("volatileIsUpdating");
 
 
 LayoutItem::LayoutItem (LayoutItem::Orientation o)
@@ -272,20 +271,16 @@ void LayoutItem::setOverlayJustification (int j)
 
 bool LayoutItem::hasComponent () const
 {
-    if (state.hasProperty (volatileSharedLayoutData)) {
-        if (SharedLayoutData* data = dynamic_cast<SharedLayoutData*>(state.getProperty(volatileSharedLayoutData).getObject())) {
-            return data->hasComponent();
-        }
+    if (SharedLayoutData* data = getData (state)) {
+        return data->hasComponent();
     }
     return false;
 }
 
 juce::Component* LayoutItem::getComponent () const
 {
-    if (state.hasProperty (volatileSharedLayoutData)) {
-        if (SharedLayoutData* data = dynamic_cast<SharedLayoutData*>(state.getProperty(volatileSharedLayoutData).getObject())) {
-            return data->getComponent();
-        }
+    if (SharedLayoutData* data = getData (state)) {
+        return data->getComponent();
     }
     return nullptr;
 }
@@ -295,6 +290,14 @@ juce::String LayoutItem::getComponentID () const
     return state.getProperty (propComponentID, "");
 }
 
+LayoutItem::SharedLayoutData* LayoutItem::getData (const juce::ValueTree& node)
+{
+    if (node.hasProperty (volatileSharedLayoutData)) {
+        return dynamic_cast<SharedLayoutData*>(node.getProperty(volatileSharedLayoutData).getObject());
+    }
+    return nullptr;
+}
+
 LayoutItem::SharedLayoutData* LayoutItem::getOrCreateData (juce::ValueTree& node, juce::UndoManager* undo)
 {
     if (node.hasProperty (volatileSharedLayoutData)) {
@@ -325,6 +328,9 @@ void LayoutItem::setComponent (juce::Component* ptr, bool owned, juce::UndoManag
     else {
         state.setProperty (propComponentID, ptr->getComponentID(), undo);
     }
+
+    // the new component needs it's bounds in the next pass
+    LayoutPlan::nodeChangedInAllPlans (state);
 }
 
 void LayoutItem::setLabelText (const juce::String& text, juce::UndoManager* undo)
@@ -519,6 +525,15 @@ void LayoutItem::constrainBounds (juce::Rectangle<int>& bounds, bool& changedWid
 
 void LayoutItem::setItemBounds (juce::Rectangle<int> b)
 {
+    int index;
+    if (LayoutPlan* plan = LayoutPlan::getPlanForNode (state, index)) {
+        plan->setItemBounds (index, b);
+        if (index == 0) {
+            // a fixed position of the root node has to survive a recompile of the plan
+            state.setProperty (volatileItemBounds, b.toString(), nullptr);
+        }
+        return;
+    }
     state.setProperty (volatileItemBounds, b.toString(), nullptr);
 }
 
@@ -529,6 +544,10 @@ void LayoutItem::setItemBounds (int x, int y, int w, int h)
 
 juce::Rectangle<int> LayoutItem::getItemBounds() const
 {
+    int index;
+    if (const LayoutPlan* plan = LayoutPlan::getPlanForNode (state, index)) {
+        return plan->getItemBounds (index);
+    }
     if (state.hasProperty (volatileItemBounds)) {
         juce::Rectangle<int> bounds = juce::Rectangle<int>::fromString (state.getProperty (volatileItemBounds).toString());
         return bounds;
@@ -549,11 +568,20 @@ juce::Rectangle<int> LayoutItem::getPaddedItemBounds () const
 
 void LayoutItem::setBoundsAreFinal (bool final)
 {
+    int index;
+    if (LayoutPlan* plan = LayoutPlan::getPlanForNode (state, index)) {
+        plan->setBoundsAreFinal (index, final);
+        return;
+    }
     state.setProperty (volatileItemBoundsFixed, final, nullptr);
 }
 
 bool LayoutItem::getBoundsAreFinal() const
 {
+    int index;
+    if (const LayoutPlan* plan = LayoutPlan::getPlanForNode (state, index)) {
+        return plan->getBoundsAreFinal (index);
+    }
     return state.getProperty (volatileItemBoundsFixed, false);
 }
 
@@ -609,23 +637,25 @@ void LayoutItem::fixUpLayoutItems ()
 }
 
 void LayoutItem::realize (juce::ValueTree& node, juce::Component* owningComponent, Layout* layout)
+{
+    ComponentLookup lookup (owningComponent);
+    realize (node, owningComponent, layout, lookup);
+}
+
+void LayoutItem::realize (juce::ValueTree& node, juce::Component* owningComponent, Layout* layout, ComponentLookup& lookup)
 {
     LayoutItem item (node);
     if (node.getType() == itemTypeComponent) {
         if (node.hasProperty (propComponentID)) {
-            if (juce::Component* component = owningComponent->findChildWithID (node.getProperty (propComponentID).toString())) {
+            if (juce::Component* component = lookup.findChildWithID (node.getProperty (propComponentID).toString())) {
                 item.setComponent (component, false);
                 return;
             }
         }
         if (node.hasProperty (propComponentName)) {
-            juce::String name = node.getProperty (propComponentName);
-            for (int i=0; i < owningComponent->getNumChildComponents(); ++i) {
-                juce::Component* child = owningComponent->getChildComponent (i);
-                if (child->getName() == name) {
-                    item.setComponent (child, false);
-                    return;
-                }
+            if (juce::Component* component = lookup.findChildWithName (node.getProperty (propComponentName).toString())) {
+                item.setComponent (component, false);
+                return;
             }
         }
         if (node.hasProperty (propLabelText)) {
@@ -645,8 +675,15 @@ void LayoutItem::realize (juce::ValueTree& node, juce::Component* owningComponen
             }
             
             owningComponent->addAndMakeVisible (newLabel);
+            lookup.addComponent (newLabel);
             item.setComponent (newLabel, true);
         }
+        else if (node.hasProperty (propComponentID)) {
+            lookup.unresolved.add (node.getProperty (propComponentID).toString());
+        }
+        else if (node.hasProperty (propComponentName)) {
+            lookup.unresolved.add (node.getProperty (propComponentName).toString());
+        }
     }
     else if (node.getType() == itemTypeSplitter) {
         LayoutSplitter::Component* splitterComponent = new LayoutSplitter::Component (layout);
@@ -655,6 +692,12 @@ void LayoutItem::realize (juce::ValueTree& node, juce::Component* owningComponen
         if (node.hasProperty (propComponentID)) {
             splitterComponent->setComponentID (node.getProperty (propComponentID).toString());
         }
+        if (node.getProperty (LayoutSplitter::propCoalesceDragging, false)) {
+            splitterComponent->setCoalesceDragging (true);
+        }
+        if (node.getProperty (LayoutSplitter::propOutlineDragging, false)) {
+            splitterComponent->setOutlineDragging (true);
+        }
         if (parent.isHorizontal()) {
             splitter.setFixedWidth (3);
             splitterComponent->setMouseCursor (juce::MouseCursor::LeftRightResizeCursor);
@@ -665,6 +708,7 @@ void LayoutItem::realize (juce::ValueTree& node, juce::Component* owningComponen
         }
         splitter.setComponent (splitterComponent, owningComponent);
         owningComponent->addAndMakeVisible (splitterComponent);
+        lookup.addComponent (splitterComponent);
         splitter.addListener (layout);
     }
     else if (node.getType() == itemTypeBuilder) {
@@ -680,6 +724,7 @@ void LayoutItem::realize (juce::ValueTree& node, juce::Component* owningComponen
                 component->setComponentID (node.getProperty (propComponentID).toString());
             }
             owningComponent->addAndMakeVisible (component);
+            lookup.addComponent (component);
             item.setComponent (component, true /* owned */);
         }
     }
@@ -696,394 +741,76 @@ void LayoutItem::realize (juce::ValueTree& node, juce::Component* owningComponen
                 group->setTextLabelPosition (juce::Justification (node.getProperty (propGroupJustification)));
             }
             owningComponent->addAndMakeVisible(group);
+            lookup.addComponent (group);
             item.setComponent (group, true);
         }
         for (int i=0; i < node.getNumChildren(); ++i) {
             juce::ValueTree child = node.getChild (i);
             LayoutItem item (child);
-            item.realize (child, owningComponent, layout);
+            item.realize (child, owningComponent, layout, lookup);
         }
     }
 }
 
-
-int LayoutItem::updateGeometry (juce::ValueTree& node, juce::Rectangle<int> bounds)
+LayoutItem::ComponentLookup::ComponentLookup (juce::Component* owningComponent)
 {
-    int needsGrowing = 0;
-    
-    if (node.getType() == itemTypeSubLayout) {
-        LayoutItem layout (node);
-        const Orientation orientation = layout.getOrientation();
-        
-        // find splitter items
-        int last = 0;
-        juce::Rectangle<int> childBounds (bounds);
-        for (int i=0; i<node.getNumChildren(); ++i) {
-            juce::ValueTree childNode = node.getChild (i);
-            LayoutItem item (childNode);
-            if (item.isOverlay() < 1) {
-                if (childNode.getType() == itemTypeSplitter) {
-                    LayoutSplitter splitter (childNode);
-                    juce::Rectangle<int> splitterBounds (bounds);
-                    
-                    // calculate minimum and maximum splitter positions
-                    int leftMinW = -1;
-                    int leftMaxW = -1;
-                    int leftMinH = -1;
-                    int leftMaxH = -1;
-                    getSizeLimits (node, leftMinW, leftMaxW, leftMinH, leftMaxH, last, i);
-                    int rightMinW = -1;
-                    int rightMaxW = -1;
-                    int rightMinH = -1;
-                    int rightMaxH = -1;
-                    getSizeLimits (node, rightMinW, rightMaxW, rightMinH, rightMaxH, i, node.getNumChildren());
-                    
-                    if (orientation == LayoutItem::LeftToRight) {
-                        if (bounds.getWidth() > 0) {
-                            float relPosition = splitter.getRelativePosition();
-                            float minRelPosition = static_cast<float>(leftMinW) / bounds.getWidth();
-                            float maxRelPosition = 1.0 - static_cast<float>(rightMinW) / bounds.getWidth();
-                            if (relPosition < minRelPosition) {
-                                splitter.setRelativePosition (minRelPosition);
-                            }
-                            else if (relPosition > maxRelPosition) {
-                                splitter.setRelativePosition (maxRelPosition);
-                            }
-                        }
-                        int right = childBounds.getX() + splitter.getRelativePosition() * bounds.getWidth();
-                        updateGeometry (node, childBounds.withRight (right-1), last, i);
-                        splitterBounds.setX (right-1);
-                        splitterBounds.setWidth (3);
-                        childBounds.setLeft (right+1);
-                    }
-                    else if (orientation == LayoutItem::TopDown) {
-                        if (bounds.getWidth() > 0) {
-                            float relPosition = splitter.getRelativePosition();
-                            float minRelPosition = static_cast<float>(leftMinH) / bounds.getWidth();
-                            float maxRelPosition = 1.0 - static_cast<float>(rightMinH) / bounds.getWidth();
-                            if (relPosition < minRelPosition) {
-                                splitter.setRelativePosition (minRelPosition);
-                            }
-                            else if (relPosition > maxRelPosition) {
-                                splitter.setRelativePosition (maxRelPosition);
-                            }
-                        }
-                        int bottom = childBounds.getY() + splitter.getRelativePosition() * bounds.getHeight();
-                        updateGeometry (node, childBounds.withBottom (bottom), last, i);
-                        splitterBounds.setY (bottom-1);
-                        splitterBounds.setHeight (3);
-                        childBounds.setTop (bottom+1);
-                    }
-                    else if (orientation == LayoutItem::RightToLeft) {
-                        if (bounds.getWidth() > 0) {
-                            float relPosition = splitter.getRelativePosition();
-                            float minRelPosition = 1.0 - static_cast<float>(leftMinW) / bounds.getWidth();
-                            float maxRelPosition = static_cast<float>(rightMinW) / bounds.getWidth();
-                            if (relPosition < minRelPosition) {
-                                splitter.setRelativePosition (minRelPosition);
-                            }
-                            else if (relPosition > maxRelPosition) {
-                                splitter.setRelativePosition (maxRelPosition);
-                            }
-                        }
-                        int left = childBounds.getX() + splitter.getRelativePosition() * bounds.getWidth();
-                        updateGeometry (node, childBounds.withLeft (left), last, i);
-                        splitterBounds.setX (left-1);
-                        splitterBounds.setWidth (3);
-                        childBounds.setRight (left-1);
-                    }
-                    else if (orientation == LayoutItem::BottomUp) {
-                        if (bounds.getWidth() > 0) {
-                            float relPosition = splitter.getRelativePosition();
-                            float minRelPosition = 1.0 - static_cast<float>(leftMinH) / bounds.getWidth();
-                            float maxRelPosition = static_cast<float>(rightMinH) / bounds.getWidth();
-                            if (relPosition < minRelPosition) {
-                                splitter.setRelativePosition (minRelPosition);
-                            }
-                            else if (relPosition > maxRelPosition) {
-                                splitter.setRelativePosition (maxRelPosition);
-                            }
-                        }
-
-                        int top = childBounds.getY() + splitter.getRelativePosition() * bounds.getHeight();
-                        updateGeometry (node, childBounds.withTop (top), last, i);
-                        splitterBounds.setY (top-1);
-                        splitterBounds.setHeight (3);
-                        childBounds.setBottom (top-1);
-                    }
-                    splitter.setItemBounds (splitterBounds);
-                    splitter.setBounds (splitterBounds);
-                    splitter.setBoundsAreFinal (true);
-                    
-                    i++;
-                    last = i;
-                }
-            }
+    if (owningComponent) {
+        for (int i=0; i < owningComponent->getNumChildComponents(); ++i) {
+            addComponent (owningComponent->getChildComponent (i));
         }
-        
-        // layout rest right of splitter, if any
-        updateGeometry (node, childBounds, last, node.getNumChildren());
-    }
-    else {
-        // give the chance to respect aspectRatio constraint - depends on given size
-        juce::Rectangle<int> childBounds (bounds);
-        LayoutItem item (node);
-        LayoutItem parent (node.getParent());
-        bool changedWidth, changedHeight;
-        item.constrainBounds (childBounds, changedWidth, changedHeight, parent.isVertical());
     }
-    return needsGrowing;
 }
 
-int LayoutItem::updateGeometry (juce::ValueTree& node, juce::Rectangle<int> bounds, int start, int end)
+void LayoutItem::ComponentLookup::addComponent (juce::Component* component)
 {
-    LayoutItem layout (node);
-    int needsGrowing = 0;
-    
-    // recursion check
-    if (node.getProperty (volatileIsUpdating, false)) {
-        return 0;
+    // keep the first child, like a linear search would find
+    const juce::String componentID = component->getComponentID();
+    if (componentID.isNotEmpty() && !childrenByID.contains (componentID)) {
+        childrenByID.set (componentID, component);
     }
-    node.setProperty (volatileIsUpdating, true, nullptr);
-    
-    float cummulatedX, cummulatedY;
-    LayoutItem::getStretch (node, cummulatedX, cummulatedY, start, end);
-    float availableWidth  = bounds.getWidth();
-    float availableHeight = bounds.getHeight();
-    const Orientation orientation = layout.getOrientation();
-    
-    if (layout.isVertical()) {
-        for (int i=start; i<juce::jmin (node.getNumChildren(), end); ++i) {
-            juce::ValueTree child (node.getChild (i));
-            LayoutItem item (child);
-            int overlay = item.isOverlay();
-            if (overlay < 1) {
-                float sx, sy;
-                LayoutItem::getStretch (child, sx, sy);
-
-                float h = bounds.getHeight() * sy / cummulatedY;
-                juce::Rectangle<int> childBounds (bounds.getX(), bounds.getY(), bounds.getWidth(), h);
-                bool changedWidth, changedHeight;
-                item.constrainBounds (childBounds, changedWidth, changedHeight, true);
-                item.setItemBounds (childBounds);
-                if (changedHeight) {
-                    item.setBoundsAreFinal (true);
-                    availableHeight -= childBounds.getHeight();
-                    cummulatedY -= sy;
-                }
-                else {
-                    item.setBoundsAreFinal (false);
-                }
-                if (changedWidth) {
-                    availableWidth = std::max (bounds.getWidth(), childBounds.getWidth());
-                }
-            }
-        }
-        needsGrowing = std::max (static_cast<int>(-availableHeight), 0);
-        
-        float y = bounds.getY();
-        if (orientation == BottomUp) {
-            y = bounds.getY() + bounds.getHeight();
-        }
-        for (int i=start; i<juce::jmin (node.getNumChildren(), end); ++i) {
-            juce::ValueTree child = node.getChild (i);
-            LayoutItem item (child);
-            
-            if (item.isOverlay() == 0) {
-                if (item.getBoundsAreFinal()) {
-                    float h = item.getItemBounds().getHeight();
-                    if (orientation == BottomUp) {
-                        y -= h;
-                    }
-                    item.setItemBounds (bounds.getX(), y, availableWidth, h);
-                    if (child.getType() == itemTypeSubLayout) {
-                        LayoutItem::updateGeometry (child, item.getPaddedItemBounds());
-                        if (juce::Component* c = item.getComponent()) {
-                            // component in a layout is a GroupComponent, so don't pad component but contents
-                            c->setBounds (item.getItemBounds());
-                        }
-                    }
-                    else if (juce::Component* c = item.getComponent()) {
-                        c->setBounds (item.getPaddedItemBounds());
-                    }
-                    
-                    if (orientation == TopDown) {
-                        y += h;
-                    }
-                }
-                else {
-                    float sx, sy;
-                    LayoutItem::getStretch (child, sx, sy);
-                    
-                    float h = availableHeight * sy /cummulatedY;
-                    if (orientation == BottomUp) {
-                        y -= h;
-                    }
-                    item.setItemBounds (bounds.getX(), y, availableWidth, h );
-                    if (child.getType() == itemTypeSubLayout) {
-                        LayoutItem sub (child);
-                        sub.updateGeometry (child, item.getPaddedItemBounds());
-                        if (juce::Component* c = item.getComponent()) {
-                            // component in a layout is a GroupComponent, so don't pad component but contents
-                            c->setBounds (item.getItemBounds());
-                        }
-                    }
-                    else if (juce::Component* c = item.getComponent()) {
-                        c->setBounds (item.getPaddedItemBounds());
-                    }
-                    item.callListenersCallback (item.getPaddedItemBounds());
-                    if (orientation == TopDown) {
-                        y += h;
-                    }
-                }
-            }
-            else {
-                // overlay other item
-                juce::Rectangle<int> overlayTarget;
-                if (item.isOverlay() == 1 && i > start) {
-                    LayoutItem previous (node.getChild(i-1));
-                    overlayTarget = previous.getItemBounds();
-                }
-                else if (item.isOverlay() == 2) {
-                    overlayTarget = bounds;
-                }
-                juce::Rectangle<int> overlayBounds (0, 0, item.getOverlayWidth() * overlayTarget.getWidth(), item.getOverlayHeight() * overlayTarget.getHeight());
-                bool changedWidth, changedHeight;
-                item.constrainBounds (overlayBounds, changedWidth, changedHeight, true);
-                juce::Justification j (item.getOverlayJustification());
-                item.setItemBounds (j.appliedToRectangle (overlayBounds, overlayTarget));
-                if (child.getType() == itemTypeSubLayout) {
-                    LayoutItem::updateGeometry (child, item.getPaddedItemBounds());
-                    if (juce::Component* c = item.getComponent()) {
-                        // component in a layout is a GroupComponent, so don't pad component but contents
-                        c->setBounds (item.getItemBounds());
-                    }
-                }
-                else if (juce::Component* c = item.getComponent()) {
-                    c->setBounds (item.getPaddedItemBounds());
-                }
-                item.callListenersCallback (item.getPaddedItemBounds());
-                
-            }
-        }
-    } else if (layout.isHorizontal()) {
-        for (int i=start; i<juce::jmin (node.getNumChildren(), end); ++i) {
-            juce::ValueTree child (node.getChild (i));
-            LayoutItem item (child);
-            int overlay = item.isOverlay();
-            if (overlay < 1) {
-                float sx, sy;
-                LayoutItem::getStretch (child, sx, sy);
-
-                float w = bounds.getWidth() * sx / cummulatedX;
-                juce::Rectangle<int> childBounds (bounds.getX(), bounds.getY(), w, bounds.getHeight());
-                bool changedWidth, changedHeight;
-                item.constrainBounds (childBounds, changedWidth, changedHeight, false);
-                item.setItemBounds (childBounds);
-                if (changedWidth) {
-                    item.setBoundsAreFinal (true);
-                    availableWidth -= childBounds.getWidth();
-                    cummulatedX -= sx;
-                }
-                else {
-                    item.setBoundsAreFinal (false);
-                }
-                if (changedHeight) {
-                    availableHeight = std::max (bounds.getHeight(), childBounds.getHeight());
-                }
-            }
-        }
-        needsGrowing = std::max (static_cast<int>(-availableWidth), 0);
+    const juce::String name = component->getName();
+    if (name.isNotEmpty() && !childrenByName.contains (name)) {
+        childrenByName.set (name, component);
+    }
+}
+
+juce::Component* LayoutItem::ComponentLookup::findChildWithID (const juce::String& componentID) const
+{
+    return childrenByID [componentID];
+}
+
+juce::Component* LayoutItem::ComponentLookup::findChildWithName (const juce::String& name) const
+{
+    return childrenByName [name];
+}
 
-        float x = bounds.getX();
-        if (orientation == RightToLeft) {
-            x = bounds.getX() + bounds.getWidth();
+
+int LayoutItem::updateGeometry (juce::ValueTree& node, juce::Rectangle<int> bounds)
+{
+    int index;
+    if (LayoutPlan* layoutPlan = LayoutPlan::getPlanForNode (node, index)) {
+        layoutPlan->ensureCompiled();
+        if (LayoutPlan::getPlanForNode (node, index) == layoutPlan) {
+            return layoutPlan->updateNodeGeometry (index, bounds);
         }
-        for (int i=start; i<juce::jmin (node.getNumChildren(), end); ++i) {
-            juce::ValueTree child = node.getChild (i);
-            LayoutItem item (child);
-            if (item.isOverlay() < 1) {
-                if (item.getBoundsAreFinal()) {
-                    float w = item.getItemBounds().getWidth();
-                    if (orientation == RightToLeft) {
-                        x -= w;
-                    }
-                    item.setItemBounds (x, bounds.getY(), w, availableHeight);
-                    juce::Rectangle<int> childBounds (x, bounds.getY(), w, availableHeight);
-                    if (child.getType() == itemTypeSubLayout) {
-                        LayoutItem::updateGeometry (child, item.getPaddedItemBounds());
-                        if (juce::Component* c = item.getComponent()) {
-                            // component in a layout is a GroupComponent, so don't pad component but contents
-                            c->setBounds (item.getItemBounds());
-                        }
-                    }
-                    else if (juce::Component* c = item.getComponent()) {
-                        c->setBounds (item.getPaddedItemBounds());
-                    }
-                    
-                    if (orientation == LeftToRight) {
-                        x += w;
-                    }
-                }
-                else {
-                    float sx, sy;
-                    LayoutItem::getStretch (child, sx, sy);
+    }
+    LayoutPlan plan;
+    plan.compile (node, LayoutPlan::WriteToNodes);
+    return plan.updateGeometry (bounds);
+}
 
-                    float w = availableWidth * sx /cummulatedX;
-                    if (orientation == RightToLeft) {
-                        x -= w;
-                    }
-                    item.setItemBounds (x, bounds.getY(), w, availableHeight);
-                    if (child.getType() == itemTypeSubLayout) {
-                        LayoutItem::updateGeometry (child, item.getPaddedItemBounds());
-                        if (juce::Component* c = item.getComponent()) {
-                            // component in a layout is a GroupComponent, so don't pad component but contents
-                            c->setBounds (item.getItemBounds());
-                        }
-                    }
-                    else if (juce::Component* c = item.getComponent()) {
-                        c->setBounds (item.getPaddedItemBounds());
-                    }
-                    item.callListenersCallback (item.getPaddedItemBounds());
-                    if (orientation == LeftToRight) {
-                        x += w;
-                    }
-                }
-            }
-            else {
-                // overlay other item
-                juce::Rectangle<int> overlayTarget;
-                if (item.isOverlay() == 1 && i > start) {
-                    LayoutItem previous (node.getChild(i-1));
-                    overlayTarget = previous.getItemBounds();
-                }
-                else if (item.isOverlay() == 2) {
-                    overlayTarget = bounds;
-                }
-                juce::Rectangle<int> overlayBounds (0, 0, item.getOverlayWidth() * overlayTarget.getWidth(), item.getOverlayHeight() * overlayTarget.getHeight());
-                bool changedWidth, changedHeight;
-                item.constrainBounds (overlayBounds, changedWidth, changedHeight, true);
-                juce::Justification j (item.getOverlayJustification());
-                item.setItemBounds (j.appliedToRectangle (overlayBounds, overlayTarget));
-                if (child.getType() == itemTypeSubLayout) {
-                    LayoutItem sub (child);
-                    sub.updateGeometry (child, item.getPaddedItemBounds());
-                    if (juce::Component* c = item.getComponent()) {
-                        // component in a layout is a GroupComponent, so don't pad component but contents
-                        c->setBounds (item.getItemBounds());
-                    }
-                }
-                else if (juce::Component* c = item.getComponent()) {
-                    c->setBounds (item.getPaddedItemBounds());
-                }
-                item.callListenersCallback (item.getPaddedItemBounds());
-                
-            }
+int LayoutItem::updateGeometry (juce::ValueTree& node, juce::Rectangle<int> bounds, int start, int end)
+{
+    int index;
+    if (LayoutPlan* layoutPlan = LayoutPlan::getPlanForNode (node, index)) {
+        layoutPlan->ensureCompiled();
+        if (LayoutPlan::getPlanForNode (node, index) == layoutPlan) {
+            return layoutPlan->updateNodeGeometry (index, bounds, start, end);
         }
     }
-    
-    node.setProperty (volatileIsUpdating, false, nullptr);
-    return needsGrowing;
+    LayoutPlan plan;
+    plan.compile (node, LayoutPlan::WriteToNodes);
+    return plan.updateNodeGeometry (0, bounds, start, end);
 }
 
 void LayoutItem::getStretch (const juce::ValueTree& node, float& w, float& h, int start, int end)
@@ -1248,6 +975,9 @@ void LayoutItem::SharedLayoutData::removeLayoutListener (LayoutItem::Listener* l
 void LayoutItem::SharedLayoutData::removeAllListeners () {
     layoutItemListeners.clear();
 }
+bool LayoutItem::SharedLayoutData::hasListeners () const {
+    return !layoutItemListeners.isEmpty();
+}
 
 void LayoutItem::SharedLayoutData::callListenersCallback (juce::ValueTree item, juce::Rectangle<int> newBounds)
 {
@@ -1268,22 +998,28 @@ void LayoutItem::addListener (LayoutItemListener* const newListener)
 
 void LayoutItem::removeListener (LayoutItemListener* const listener)
 {
-    if (state.hasProperty (volatileSharedLayoutData)) {
-        SharedLayoutData* data = getOrCreateData (state);
+    if (SharedLayoutData* data = getData (state)) {
         data->removeLayoutListener (listener);
     }
 }
 
 void LayoutItem::callListenersCallback (juce::Rectangle<int> newBounds)
 {
-    SharedLayoutData* data = getOrCreateData (state);
-    data->callListenersCallback (state, newBounds);
+    // items without listeners don't need a data blob just for this call
+    if (SharedLayoutData* data = getData (state)) {
+        if (data->hasListeners()) {
+            data->callListenersCallback (state, newBounds);
+        }
+    }
 }
 
 void LayoutItem::callListenersCallback (float relativePosition, bool final)
 {
-    SharedLayoutData* data = getOrCreateData (state);
-    data->callListenersCallback (state, relativePosition, final);
+    if (SharedLayoutData* data = getData (state)) {
+        if (data->hasListeners()) {
+            data->callListenersCallback (state, relativePosition, final);
+        }
+    }
 }
 
 //==============================================================================
@@ -1291,6 +1027,8 @@ void LayoutItem::callListenersCallback (float relativePosition, bool final)
 const juce::Identifier LayoutSplitter::propRelativePosition       ("relativePosition");
 const juce::Identifier LayoutSplitter::propRelativeMinPosition    ("relativeMinPosition");
 const juce::Identifier LayoutSplitter::propRelativeMaxPosition    ("relativeMaxPosition");
+const juce::Identifier LayoutSplitter::propCoalesceDragging       ("coalesceDragging");
+const juce::Identifier LayoutSplitter::propOutlineDragging        ("outlineDragging");
 
 
 LayoutSplitter::LayoutSplitter (juce::ValueTree& node)
@@ -1305,6 +1043,12 @@ LayoutSplitter::~LayoutSplitter()
 
 float LayoutSplitter::getRelativePosition() const
 {
+    int index;
+    if (const LayoutPlan* plan = LayoutPlan::getPlanForNode (state, index)) {
+        if (plan->isCompiled()) {
+            return plan->getRelativePosition (index);
+        }
+    }
     return state.getProperty (propRelativePosition, 0.5);
 }
 
@@ -1346,9 +1090,80 @@ void LayoutSplitter::setBounds (juce::Rectangle<int> b)
     }
 }
 
+/**
+ The outline shown instead of moving the splitter, while outline dragging
+ */
+class LayoutSplitter::Component::Outline : public juce::Component
+{
+public:
+    Outline ()
+    {
+        setInterceptsMouseClicks (false, false);
+    }
+
+    void paint (juce::Graphics& g) override
+    {
+        g.fillAll (juce::Colours::grey.withAlpha (0.6f));
+    }
+};
+
 LayoutSplitter::Component::Component (Layout* layout)
-: layoutPtr (layout)
+: layoutPtr (layout),
+  coalesceRate (0),
+  pendingPosition (0.0f),
+  hasPendingPosition (false),
+  outlineDragging (false)
+{
+}
+
+LayoutSplitter::Component::~Component ()
+{
+}
+
+void LayoutSplitter::Component::setOutlineDragging (bool shouldDrawOutline)
+{
+    outlineDragging = shouldDrawOutline;
+}
+
+bool LayoutSplitter::Component::isOutlineDragging () const
+{
+    return outlineDragging;
+}
+
+void LayoutSplitter::Component::showOutline (juce::Component* parentComponent, juce::Rectangle<int> layoutBounds, bool horizontal, float position)
+{
+    if (outline == nullptr) {
+        outline = std::unique_ptr<Outline> (new Outline());
+    }
+    if (outline->getParentComponent() != parentComponent) {
+        parentComponent->addAndMakeVisible (outline.get());
+    }
+    outline->toFront (false);
+    if (horizontal) {
+        const int x = layoutBounds.getX() + juce::roundToInt (position * layoutBounds.getWidth());
+        outline->setBounds (x - 1, getY(), getWidth(), getHeight());
+    }
+    else {
+        const int y = layoutBounds.getY() + juce::roundToInt (position * layoutBounds.getHeight());
+        outline->setBounds (getX(), y - 1, getWidth(), getHeight());
+    }
+}
+
+void LayoutSplitter::Component::setCoalesceDragging (bool shouldCoalesce, int framesPerSecond)
 {
+    coalesceRate = shouldCoalesce ? juce::jmax (1, framesPerSecond) : 0;
+    if (!shouldCoalesce) {
+        stopTimer();
+        if (hasPendingPosition) {
+            hasPendingPosition = false;
+            applyPosition (pendingPosition, false);
+        }
+    }
+}
+
+bool LayoutSplitter::Component::isCoalescingDragging () const
+{
+    return coalesceRate > 0;
 }
 
 void LayoutSplitter::Component::paint (juce::Graphics& g)
@@ -1380,10 +1195,26 @@ void LayoutSplitter::Component::mouseDrag (const juce::MouseEvent &event)
                 else {
                     pos = (event.getEventRelativeTo(parentComponent).position.getY() - layoutBounds.getY()) / layoutBounds.getHeight();
                 }
-                splitter.setRelativePosition (juce::jmax (splitter.getMinimumRelativePosition(), juce::jmin (splitter.getMaximumRelativePosition(), pos)));
-                
-                layoutPtr->updateGeometry();
-                splitter.callListenersCallback (splitter.getRelativePosition(), false);
+                pos = juce::jmax (splitter.getMinimumRelativePosition(), juce::jmin (splitter.getMaximumRelativePosition(), pos));
+
+                if (outlineDragging) {
+                    // the layout is updated on mouseUp
+                    pendingPosition = pos;
+                    hasPendingPosition = true;
+                    showOutline (parentComponent, layoutBounds, horizontal, pos);
+                    return;
+                }
+
+                if (coalesceRate > 0) {
+                    // the layout is updated in the next timerCallback
+                    pendingPosition = pos;
+                    hasPendingPosition = true;
+                    if (!isTimerRunning()) {
+                        startTimerHz (coalesceRate);
+                    }
+                    return;
+                }
+                applyPosition (pos, false);
             }
         }
     }
@@ -1391,13 +1222,46 @@ void LayoutSplitter::Component::mouseDrag (const juce::MouseEvent &event)
 
 void LayoutSplitter::Component::mouseUp (const juce::MouseEvent& event)
 {
+    stopTimer();
+    outline = nullptr;
+    if (hasPendingPosition) {
+        hasPendingPosition = false;
+        applyPosition (pendingPosition, true);
+        return;
+    }
     if (layoutPtr) {
         juce::ValueTree item = layoutPtr->getLayoutItem (this);
         if (item.isValid()) {
             LayoutSplitter  splitter (item);
             if (splitter.isValid()) {
+                layoutPtr->storeSplitterPosition (item);
                 splitter.callListenersCallback (splitter.getRelativePosition(), true);
             }
         }
     }
 }
+
+void LayoutSplitter::Component::timerCallback ()
+{
+    if (hasPendingPosition) {
+        hasPendingPosition = false;
+        applyPosition (pendingPosition, false);
+    }
+    else {
+        // the mouse didn't move during the last frame
+        stopTimer();
+    }
+}
+
+void LayoutSplitter::Component::applyPosition (float position, bool final)
+{
+    if (layoutPtr) {
+        juce::ValueTree item = layoutPtr->getLayoutItem (this);
+        if (item.isValid()) {
+            // only the items around the splitter can change
+            layoutPtr->moveSplitter (item, position, final);
+            LayoutSplitter splitter (item);
+            splitter.callListenersCallback (splitter.getRelativePosition(), final);
+        }
+    }
+}
@@ -43,6 +43,7 @@
 #include "juce_gui_basics/juce_gui_basics.h"
 
 class Layout;
+class LayoutPlan;
 class LayoutSplitter;
 
 //==============================================================================
@@ -85,6 +86,35 @@ public:
         
     };
 
+    //==============================================================================
+    /**
+     The ComponentLookup finds the children of the owningComponent by componentID
+     or componentName, so realize doesn't need to search all children for each item.
+     */
+    class ComponentLookup {
+    public:
+        /** Create a lookup of all children of owningComponent */
+        ComponentLookup (juce::Component* owningComponent);
+
+        /** Add a component, that was created while realizing the layout */
+        void addComponent (juce::Component* component);
+
+        /** Returns the first child with that componentID, like Component::findChildWithID */
+        juce::Component* findChildWithID (const juce::String& componentID) const;
+
+        /** Returns the first child with that name */
+        juce::Component* findChildWithName (const juce::String& name) const;
+
+        /** The componentIDs and componentNames, that could not be found */
+        juce::StringArray unresolved;
+
+    private:
+        juce::HashMap<juce::String, juce::Component*> childrenByID;
+        juce::HashMap<juce::String, juce::Component*> childrenByName;
+
+        JUCE_DECLARE_NON_COPYABLE (ComponentLookup)
+    };
+
 private:
     //==============================================================================
     /**
@@ -95,6 +125,7 @@ private:
         
     private:
         friend LayoutItem;
+        friend LayoutPlan;
         
         /** @internal */
         const juce::Component* getComponent() const;
@@ -116,6 +147,9 @@ private:
         
         /** @internal */
         void removeAllListeners ();
+
+        /** @internal */
+        bool hasListeners () const;
         
         /** @internal */
         void callListenersCallback (juce::ValueTree item, juce::Rectangle<int> newBounds);
@@ -129,6 +163,9 @@ private:
         juce::ScopedPointer<juce::Component>            ownedComponent;
         
         juce::ListenerList<Listener> layoutItemListeners;
+
+        // the plans compiled from the tree below this node
+        juce::Array<LayoutPlan*>                        plans;
     };
 
 
@@ -247,6 +284,12 @@ public:
     void setComponent (juce::Component* ptr, bool owned=false, juce::UndoManager* undo=nullptr);
 
     
+    /**
+     Returns the shared layout data blob of a node, or nullptr, if none was created yet.
+     @see getOrCreateData
+     */
+    static LayoutItem::SharedLayoutData* getData (const juce::ValueTree& node);
+
     /**
      Get or create a shared layout data blob for state node. @see SharedLayoutData
      */
@@ -491,6 +534,8 @@ public:
      returns the calculated bounds of the item or layout.
      Calling this on the root node returns only a valid rectangle, if it was set
      as fixed bounds.
+     If the item belongs to a compiled Layout, the bounds are read from the
+     LayoutPlan without any parsing.
      */
     juce::Rectangle<int> getItemBounds() const;
 
@@ -529,9 +574,16 @@ public:
      Hook to component or create an owned component
      */
     virtual void realize (juce::ValueTree& node, juce::Component* owningComponent, Layout* layout);
+
+    /**
+     Hook to component or create an owned component, resolving the components
+     by componentID or componentName through the lookup
+     */
+    void realize (juce::ValueTree& node, juce::Component* owningComponent, Layout* layout, ComponentLookup& lookup);
     
     /**
      Recompute the geometry of all components. Recoursively recomputes all sub layouts.
+     This compiles a temporary LayoutPlan for node, a Layout keeps it's plan between passes.
      */
     static int updateGeometry (juce::ValueTree& node, juce::Rectangle<int> bounds);
     
@@ -626,12 +678,13 @@ public:
     static const juce::Identifier propGroupJustification;
     
 private:
+    friend LayoutPlan;
+
     JUCE_LEAK_DETECTOR (LayoutItem)
 
     static const juce::Identifier volatileSharedLayoutData;
     static const juce::Identifier volatileItemBounds;
     static const juce::Identifier volatileItemBoundsFixed;
-    static const juce::Identifier volatileIsUpdating;
     
 
 };
@@ -679,12 +732,36 @@ public:
     /** 
      Splitter component for mouse interaction 
      */
-    class Component : public juce::Component {
+    class Component : public juce::Component,
+                      private juce::Timer {
     public:
         /**
          Constructor with a reference to the layout
          */
         Component (Layout* layout);
+
+        /** Destructor */
+        ~Component ();
+
+        /**
+         If set, mouse drags only record the latest position and the layout is
+         updated at most framesPerSecond times. The last position is applied on
+         mouseUp. This is off by default, so each drag event updates the layout.
+         */
+        void setCoalesceDragging (bool shouldCoalesce, int framesPerSecond=60);
+
+        /** Returns true, if drag events are coalesced @see setCoalesceDragging */
+        bool isCoalescingDragging () const;
+
+        /**
+         If set, only a lightweight outline is painted over the owning component
+         while dragging, and the layout is updated once on mouseUp. Use this, if
+         the items around the splitter are expensive to resize.
+         */
+        void setOutlineDragging (bool shouldDrawOutline);
+
+        /** Returns true, if only an outline is dragged @see setOutlineDragging */
+        bool isOutlineDragging () const;
         
         /**
          Paint the splitter handle. You can override this to customize the drawing
@@ -701,13 +778,32 @@ public:
          */
         void mouseUp (const juce::MouseEvent& event) override;
         
+        /** @internal */
+        void timerCallback () override;
+
     private:
+        /** @internal */
+        void applyPosition (float position, bool final);
+
+        /** @internal */
+        void showOutline (juce::Component* parentComponent, juce::Rectangle<int> layoutBounds, bool horizontal, float position);
+
         juce::WeakReference<Layout> layoutPtr;
+
+        int     coalesceRate;
+        float   pendingPosition;
+        bool    hasPendingPosition;
+
+        class Outline;
+        std::unique_ptr<Outline> outline;
+        bool    outlineDragging;
     };
 
     static const juce::Identifier propRelativePosition;
     static const juce::Identifier propRelativeMinPosition;
     static const juce::Identifier propRelativeMaxPosition;
+    static const juce::Identifier propCoalesceDragging;
+    static const juce::Identifier propOutlineDragging;
     
 private:
     JUCE_LEAK_DETECTOR (LayoutSplitter)
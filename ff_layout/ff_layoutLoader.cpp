@@ -0,0 +1,127 @@
+/*
+  ==============================================================================
+
+  Copyright (c) 2016 - 2017, Daniel Walz
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without modification,
+  are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+     list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors
+     may be used to endorse or promote products derived from this software without
+     specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+  INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+  OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+  OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    ff_layoutLoader.cpp
+    Created: 18 Oct 2026 1:20:48pm
+
+  ==============================================================================
+*/
+
+
+#include "ff_layout.h"
+
+JUCE_IMPLEMENT_SINGLETON (LayoutLoader)
+
+/**
+ A job, that loads one layout and posts the result to the message thread
+ */
+class LayoutLoader::LoadJob : public juce::ThreadPoolJob
+{
+public:
+    LoadJob (const juce::String& xmlToLoad, const void* dataToLoad, size_t sizeToLoad, Callback callbackToUse)
+      : juce::ThreadPoolJob ("Layout loader"),
+        xml (xmlToLoad),
+        data (dataToLoad),
+        size (sizeToLoad),
+        callback (callbackToUse)
+    {
+    }
+
+    JobStatus runJob () override
+    {
+        PreparedLayout::Ptr prepared = (data != nullptr) ? LayoutLoader::load (data, size)
+                                                         : LayoutLoader::load (xml);
+        Callback callbackToCall = callback;
+        juce::MessageManager::callAsync ([callbackToCall, prepared] { callbackToCall (prepared); });
+        return jobHasFinished;
+    }
+
+private:
+    juce::String    xml;
+    const void*     data;
+    size_t          size;
+    Callback        callback;
+
+    JUCE_DECLARE_NON_COPYABLE (LoadJob)
+};
+
+LayoutLoader::LayoutLoader ()
+  : pool (juce::jlimit (1, 4, juce::SystemStats::getNumCpus() - 1))
+{
+}
+
+LayoutLoader::~LayoutLoader ()
+{
+    pool.removeAllJobs (true, 10000);
+    clearSingletonInstance();
+}
+
+void LayoutLoader::loadAsync (const juce::String& xml, Callback callback)
+{
+    jassert (callback);
+    getInstance()->pool.addJob (new LoadJob (xml, nullptr, 0, callback), true);
+}
+
+void LayoutLoader::loadAsync (const void* data, size_t size, Callback callback)
+{
+    jassert (callback && data != nullptr);
+    getInstance()->pool.addJob (new LoadJob (juce::String(), data, size, callback), true);
+}
+
+PreparedLayout::Ptr LayoutLoader::load (const juce::String& xml)
+{
+    PreparedLayout::Ptr prepared = new PreparedLayout();
+    prepared->state = LayoutDefinitionCache::getInstance()->getLayoutFromXml (xml, &prepared->errorMessage);
+    compile (*prepared);
+    return prepared;
+}
+
+PreparedLayout::Ptr LayoutLoader::load (const void* data, size_t size)
+{
+    PreparedLayout::Ptr prepared = new PreparedLayout();
+    prepared->state = LayoutDefinitionCache::getInstance()->getLayoutFromBinary (data, size);
+    if (!prepared->state.isValid()) {
+        prepared->errorMessage = "not a binary layout or written by a newer version";
+    }
+    compile (*prepared);
+    return prepared;
+}
+
+void LayoutLoader::compile (PreparedLayout& prepared)
+{
+    // nobody else knows the tree yet, so binding the nodes to the plan is safe on any thread
+    if (prepared.state.isValid()) {
+        prepared.plan.reset (new LayoutPlan());
+        prepared.plan->compile (prepared.state);
+    }
+}
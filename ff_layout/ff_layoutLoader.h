@@ -0,0 +1,129 @@
+/*
+  ==============================================================================
+
+  Copyright (c) 2016 - 2017, Daniel Walz
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without modification,
+  are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+     list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors
+     may be used to endorse or promote products derived from this software without
+     specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+  INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+  OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+  OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    ff_layoutLoader.h
+    Created: 18 Oct 2026 1:20:48pm
+
+  ==============================================================================
+*/
+
+#pragma once
+
+
+//==============================================================================
+/**
+ A layout definition, that was parsed and compiled, but not realized yet. It is
+ created by the LayoutLoader and handed to the Layout constructor, which takes
+ over the tree and the plan.
+ */
+class PreparedLayout : public juce::ReferenceCountedObject
+{
+public:
+    typedef juce::ReferenceCountedObjectPtr<PreparedLayout> Ptr;
+
+    PreparedLayout () {}
+
+    /** Returns true, if the definition was loaded and is not used by a Layout yet */
+    bool isValid () const { return state.isValid(); }
+
+    /** The parsed layout tree */
+    juce::ValueTree             state;
+
+    /** The plan compiled from state */
+    std::unique_ptr<LayoutPlan> plan;
+
+    /** The reason, why the definition could not be loaded */
+    juce::String                errorMessage;
+
+private:
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PreparedLayout)
+};
+
+//==============================================================================
+/**
+ The LayoutLoader parses and compiles layout definitions on a background thread,
+ so the message thread stays free, e.g. to animate a spinner while an editor is
+ loading. Only realizing the layout, i.e. creating labels, group components and
+ splitters and binding the components, and the first pass run on the message
+ thread:
+
+ \code{.cpp}
+ juce::Component::SafePointer<MyEditor> editor (this);
+ LayoutLoader::loadAsync (BinaryData::layout_bin, BinaryData::layout_binSize,
+                          [editor] (PreparedLayout::Ptr prepared)
+ {
+     if (editor != nullptr && prepared->isValid()) {
+         editor->layout.reset (new Layout (*prepared, editor));
+         editor->resized();
+     }
+ });
+ \endcode
+ */
+class LayoutLoader : public juce::DeletedAtShutdown
+{
+public:
+    typedef std::function<void (PreparedLayout::Ptr)> Callback;
+
+    LayoutLoader ();
+    ~LayoutLoader ();
+
+    JUCE_DECLARE_SINGLETON (LayoutLoader, false)
+
+    /**
+     Parse and compile a layout xml on a background thread. The callback is
+     called on the message thread with the result.
+     */
+    static void loadAsync (const juce::String& xml, Callback callback);
+
+    /**
+     Read and compile a binary layout on a background thread. The data must stay
+     valid until the callback was called, which is the case for BinaryData.
+     */
+    static void loadAsync (const void* data, size_t size, Callback callback);
+
+    /** Parse and compile a layout xml on the calling thread */
+    static PreparedLayout::Ptr load (const juce::String& xml);
+
+    /** Read and compile a binary layout on the calling thread */
+    static PreparedLayout::Ptr load (const void* data, size_t size);
+
+private:
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LayoutLoader)
+
+    class LoadJob;
+
+    /** @internal */
+    static void compile (PreparedLayout& prepared);
+
+    juce::ThreadPool pool;
+};
@@ -0,0 +1,1615 @@
+/*
+  ==============================================================================
+
+  Copyright (c) 2016 - 2017, Daniel Walz
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without modification,
+  are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+     list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors
+     may be used to endorse or promote products derived from this software without
+     specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+  INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+  OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+  OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    ff_layoutPlan.cpp
+    Created: 17 Oct 2026 9:30:12am
+
+  ==============================================================================
+*/
+
+
+#include "ff_layout.h"
+
+LayoutPlan::LayoutPlan ()
+  : compiled (false),
+    binding (BindToNodes),
+    isUpdating (false),
+    nodeChangeDepth (0),
+    aggregatesPending (false),
+    slicing (false),
+    revision (0),
+    cacheSize (0),
+    parallelThreshold (0),
+    maxNumJobs (0)
+{
+}
+
+LayoutPlan::~LayoutPlan ()
+{
+    unbindRoot();
+}
+
+void LayoutPlan::compile (const juce::ValueTree& rootNode, Binding bindingToUse)
+{
+    // keep the computed bounds of nodes, that are still present
+    juce::Array<juce::ValueTree> previousNodes;
+    juce::Array<int> previousFirstChildren;
+    juce::Array<int> previousNumChildren;
+    juce::Array<juce::Rectangle<int> > previousBounds;
+    juce::Array<juce::Rectangle<int> > previousInputBounds;
+    juce::Array<bool> previousDirty;
+    juce::Array<bool> previousSelfDirty;
+    juce::Array<CommittedState> previousCommitted;
+    juce::Array<CommitTarget> previousTargets;
+    previousNodes.swapWith (nodes);
+    previousFirstChildren.swapWith (firstChildren);
+    previousNumChildren.swapWith (numChildren);
+    previousBounds.swapWith (itemBounds);
+    previousInputBounds.swapWith (inputBounds);
+    previousDirty.swapWith (dirty);
+    previousSelfDirty.swapWith (selfDirty);
+    previousCommitted.swapWith (committed);
+    previousTargets.swapWith (targets);
+
+    root = rootNode;
+    binding = bindingToUse;
+    invalidateCache();
+
+    // the indices of an incomplete sliced pass refer to the old nodes, and the
+    // part computed so far was never committed
+    if (slicing) {
+        for (int i=0; i < previousDirty.size(); ++i) {
+            previousDirty.set (i, true);
+        }
+    }
+    slicing = false;
+    sliced.bounds.clearQuick();
+    sliced.notifications.clearQuick();
+    sliced.deferred.clearQuick();
+    sliced.deferredBoundsAt.clearQuick();
+    sliced.deferredNotificationsAt.clearQuick();
+    parents.clearQuick();
+    types.clearQuick();
+    orientations.clearQuick();
+    stretchX.clearQuick();
+    stretchY.clearQuick();
+    minWidths.clearQuick();
+    maxWidths.clearQuick();
+    minHeights.clearQuick();
+    maxHeights.clearQuick();
+    aspectRatios.clearQuick();
+    paddingTop.clearQuick();
+    paddingLeft.clearQuick();
+    paddingRight.clearQuick();
+    paddingBottom.clearQuick();
+    overlays.clearQuick();
+    overlayWidths.clearQuick();
+    overlayHeights.clearQuick();
+    overlayJustifications.clearQuick();
+    relativePositions.clearQuick();
+    sharedData.clearQuick();
+    childStretchX.clearQuick();
+    childStretchY.clearQuick();
+    cummulatedStretchX.clearQuick();
+    cummulatedStretchY.clearQuick();
+    pending.bounds.clearQuick();
+    pending.notifications.clearQuick();
+    subtreeSizes.clearQuick();
+    segmentLimits.clearQuick();
+    remainingLimits.clearQuick();
+    boundsAreFinal.clearQuick();
+
+    if (root.isValid()) {
+        addNode (root, -1);
+
+        // breadth first, so all children of a node are added in one consecutive range
+        for (int index=0; index < nodes.size(); ++index) {
+            const juce::ValueTree node = nodes.getUnchecked (index);
+            firstChildren.set (index, nodes.size());
+            if (node.getType() == LayoutItem::itemTypeSubLayout) {
+                for (int i=0; i < node.getNumChildren(); ++i) {
+                    addNode (node.getChild (i), index);
+                }
+                numChildren.set (index, node.getNumChildren());
+            }
+        }
+
+        // children have higher indices than their parents, so this is bottom up
+        for (int index=nodes.size() - 1; index >= 0; --index) {
+            updateStretch (index);
+            updateSplitterLimits (index);
+
+            int size = 1;
+            const int first = firstChildren.getUnchecked (index);
+            for (int i=0; i < numChildren.getUnchecked (index); ++i) {
+                size += subtreeSizes.getUnchecked (first + i);
+            }
+            subtreeSizes.set (index, size);
+        }
+
+        // find the nodes in the previous plan by walking both trees, children keep their order
+        juce::Array<int> previousIndices;
+        int lastParent = -1;
+        int nextSibling = 0;
+        for (int index=0; index < nodes.size(); ++index) {
+            const juce::ValueTree node = nodes.getUnchecked (index);
+            const int parent = parents.getUnchecked (index);
+            int previous = -1;
+            if (parent < 0) {
+                previous = previousNodes [0] == node ? 0 : -1;
+            }
+            else if (previousIndices.getUnchecked (parent) >= 0) {
+                const int previousParent = previousIndices.getUnchecked (parent);
+                const int first = previousFirstChildren.getUnchecked (previousParent);
+                const int num   = previousNumChildren.getUnchecked (previousParent);
+                if (parent != lastParent) {
+                    lastParent = parent;
+                    nextSibling = 0;
+                }
+                for (int i=0; i < num; ++i) {
+                    const int candidate = first + (nextSibling + i) % num;
+                    if (previousNodes.getUnchecked (candidate) == node) {
+                        previous = candidate;
+                        nextSibling = candidate - first + 1;
+                        break;
+                    }
+                }
+            }
+            previousIndices.add (previous);
+
+            if (previous >= 0) {
+                itemBounds.set  (index, previousBounds.getUnchecked (previous));
+                inputBounds.set (index, previousInputBounds.getUnchecked (previous));
+                dirty.set       (index, previousDirty.getUnchecked (previous));
+                selfDirty.set   (index, previousSelfDirty.getUnchecked (previous));
+                committed.set   (index, previousCommitted.getUnchecked (previous));
+                targets.set     (index, previousTargets.getUnchecked (previous));
+            }
+            else if (node.hasProperty (LayoutItem::volatileItemBounds)) {
+                itemBounds.set (index, juce::Rectangle<int>::fromString (node.getProperty (LayoutItem::volatileItemBounds).toString()));
+            }
+        }
+    }
+    compiled = true;
+
+    // the plan is found through the data of it's root node, so the other nodes are not touched
+    unbindRoot();
+    if (binding == BindToNodes && root.isValid()) {
+        boundRoot = root;
+        LayoutItem::getOrCreateData (boundRoot)->plans.addIfNotAlreadyThere (this);
+    }
+}
+
+void LayoutPlan::ensureCompiled ()
+{
+    if (!compiled && !isUpdating) {
+        compile (root, binding);
+    }
+}
+
+void LayoutPlan::invalidate ()
+{
+    compiled = false;
+}
+
+bool LayoutPlan::isCompiled () const
+{
+    return compiled;
+}
+
+int LayoutPlan::getNumNodes () const
+{
+    return nodes.size();
+}
+
+juce::ValueTree LayoutPlan::getNode (int index) const
+{
+    return nodes [index];
+}
+
+void LayoutPlan::nodeChanged (const juce::ValueTree& node)
+{
+    const int index = getIndexOfNode (node);
+    if (index >= 0) {
+        if (compiled) {
+            readNode (index);
+            if (nodeChangeDepth > 0) {
+                aggregatesPending = true;
+            }
+            else {
+                updateStretch (index);
+                updateSplitterLimits (index);
+                const int parent = parents.getUnchecked (index);
+                if (parent >= 0) {
+                    updateStretch (parent);
+                    updateSplitterLimits (parent);
+                }
+            }
+            // the component might have been exchanged, so apply the bounds again
+            committed.set (index, CommittedState());
+        }
+        markDirty (index);
+    }
+}
+
+void LayoutPlan::beginNodeChanges ()
+{
+    ++nodeChangeDepth;
+}
+
+void LayoutPlan::endNodeChanges ()
+{
+    jassert (nodeChangeDepth > 0);
+    if (--nodeChangeDepth > 0 || !aggregatesPending) {
+        return;
+    }
+    aggregatesPending = false;
+    if (compiled) {
+        // children have higher indices than their parents, so this is bottom up
+        for (int index=nodes.size() - 1; index >= 0; --index) {
+            updateStretch (index);
+            updateSplitterLimits (index);
+        }
+    }
+}
+
+void LayoutPlan::markDirty (const juce::ValueTree& node)
+{
+    // if the plan is invalidated, the flags are set in the previous data and kept
+    // when compiling. New nodes are dirty anyway.
+    const int index = getIndexOfNode (node);
+    if (index >= 0) {
+        markDirty (index);
+    }
+}
+
+void LayoutPlan::markDirty (int index)
+{
+    selfDirty.set (index, true);
+
+    // a change in a node can change the stretch and size limits of all parents
+    while (index >= 0) {
+        dirty.set (index, true);
+        index = parents.getUnchecked (index);
+    }
+
+    invalidateCache();
+}
+
+bool LayoutPlan::isComputedProperty (const juce::Identifier& property)
+{
+    return property == LayoutItem::volatileItemBounds
+        || property == LayoutItem::volatileItemBoundsFixed;
+}
+
+void LayoutPlan::unbindRoot ()
+{
+    if (LayoutItem::SharedLayoutData* data = LayoutItem::getData (boundRoot)) {
+        data->plans.removeFirstMatchingValue (this);
+    }
+    boundRoot = juce::ValueTree();
+}
+
+LayoutPlan* LayoutPlan::getPlanForNode (const juce::ValueTree& node, int& index)
+{
+    // a plan is registered at it's root, usually there is only one per tree
+    for (juce::ValueTree ancestor = node; ancestor.isValid(); ancestor = ancestor.getParent()) {
+        if (const LayoutItem::SharedLayoutData* data = LayoutItem::getData (ancestor)) {
+            for (int i=0; i < data->plans.size(); ++i) {
+                LayoutPlan* plan = data->plans.getUnchecked (i);
+                index = plan->getIndexOfNode (node);
+                if (index >= 0) {
+                    return plan;
+                }
+            }
+        }
+    }
+    return nullptr;
+}
+
+void LayoutPlan::nodeChangedInAllPlans (const juce::ValueTree& node)
+{
+    for (juce::ValueTree ancestor = node; ancestor.isValid(); ancestor = ancestor.getParent()) {
+        if (const LayoutItem::SharedLayoutData* data = LayoutItem::getData (ancestor)) {
+            const juce::Array<LayoutPlan*> plans (data->plans);
+            for (int i=0; i < plans.size(); ++i) {
+                plans.getUnchecked (i)->nodeChanged (node);
+            }
+        }
+    }
+}
+
+int LayoutPlan::getIndexOfNode (const juce::ValueTree& node) const
+{
+    if (node == root) {
+        return nodes [0] == node ? 0 : -1;
+    }
+    const juce::ValueTree parent = node.getParent();
+    const int parentIndex = parent.isValid() ? getIndexOfNode (parent) : -1;
+    if (parentIndex < 0) {
+        return -1;
+    }
+    const int first = firstChildren.getUnchecked (parentIndex);
+    const int num   = numChildren.getUnchecked (parentIndex);
+    const int position = parent.indexOf (node);
+    if (juce::isPositiveAndBelow (position, num) && nodes.getUnchecked (first + position) == node) {
+        return first + position;
+    }
+    // the plan is outdated and the node moved among it's siblings
+    for (int i=first; i < first + num; ++i) {
+        if (nodes.getUnchecked (i) == node) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void LayoutPlan::addNode (const juce::ValueTree& node, int parent)
+{
+    nodes.add (node);
+    parents.add (parent);
+    firstChildren.add (0);
+    numChildren.add (0);
+    types.add (LayoutItem::Invalid);
+    orientations.add (LayoutItem::Unknown);
+    stretchX.add (1.0f);
+    stretchY.add (1.0f);
+    minWidths.add (-1);
+    maxWidths.add (-1);
+    minHeights.add (-1);
+    maxHeights.add (-1);
+    aspectRatios.add (0.0f);
+    paddingTop.add (0);
+    paddingLeft.add (0);
+    paddingRight.add (0);
+    paddingBottom.add (0);
+    overlays.add (0);
+    overlayWidths.add (1.0f);
+    overlayHeights.add (1.0f);
+    overlayJustifications.add (36);
+    relativePositions.add (0.5f);
+    childStretchX.add (1.0f);
+    childStretchY.add (1.0f);
+    cummulatedStretchX.add (1.0f);
+    cummulatedStretchY.add (1.0f);
+    segmentLimits.add (SizeLimits());
+    remainingLimits.add (SizeLimits());
+    sharedData.add (nullptr);
+    itemBounds.add (juce::Rectangle<int>());
+    boundsAreFinal.add (false);
+    dirty.add (true);
+    selfDirty.add (true);
+    inputBounds.add (juce::Rectangle<int>());
+    committed.add (CommittedState());
+    targets.add (CommitTarget());
+    subtreeSizes.add (1);
+
+    readNode (nodes.size() - 1);
+}
+
+void LayoutPlan::readNode (int index)
+{
+    const juce::ValueTree node = nodes.getUnchecked (index);
+    const juce::Identifier type = node.getType();
+    const LayoutItem item (node);
+
+    if (type == LayoutItem::itemTypeSubLayout) {
+        types.set (index, LayoutItem::SubLayout);
+    }
+    else if (type == LayoutItem::itemTypeComponent || type == LayoutItem::itemTypeBuilder) {
+        types.set (index, LayoutItem::ComponentItem);
+    }
+    else if (type == LayoutItem::itemTypeLabeledComponent) {
+        types.set (index, LayoutItem::LabeledComponentItem);
+    }
+    else if (type == LayoutItem::itemTypeSplitter) {
+        types.set (index, LayoutItem::SplitterItem);
+    }
+    else if (type == LayoutItem::itemTypeSpacer) {
+        types.set (index, LayoutItem::SpacerItem);
+    }
+    else if (type == LayoutItem::itemTypeLine) {
+        types.set (index, LayoutItem::LineItem);
+    }
+    else {
+        types.set (index, LayoutItem::Invalid);
+    }
+
+    // sub layouts default to the cummulated stretch of the children
+    const float defaultStretch = (type == LayoutItem::itemTypeSubLayout) ? -1.0f : 1.0f;
+
+    orientations.set          (index, item.getOrientation());
+    stretchX.set              (index, node.getProperty (LayoutItem::propStretchX, defaultStretch));
+    stretchY.set              (index, node.getProperty (LayoutItem::propStretchY, defaultStretch));
+    minWidths.set             (index, item.getMinimumWidth());
+    maxWidths.set             (index, item.getMaximumWidth());
+    minHeights.set            (index, item.getMinimumHeight());
+    maxHeights.set            (index, item.getMaximumHeight());
+    aspectRatios.set          (index, item.getAspectRatio());
+    paddingTop.set            (index, item.getPaddingTop());
+    paddingLeft.set           (index, item.getPaddingLeft());
+    paddingRight.set          (index, item.getPaddingRight());
+    paddingBottom.set         (index, item.getPaddingBottom());
+    overlays.set              (index, item.isOverlay());
+    overlayWidths.set         (index, item.getOverlayWidth());
+    overlayHeights.set        (index, item.getOverlayHeight());
+    overlayJustifications.set (index, item.getOverlayJustification());
+    relativePositions.set     (index, node.getProperty (LayoutSplitter::propRelativePosition, 0.5));
+
+    sharedData.set (index, LayoutItem::getData (node));
+}
+
+bool LayoutPlan::isHorizontal (int index) const
+{
+    const LayoutItem::Orientation o = orientations.getUnchecked (index);
+    return o == LayoutItem::LeftToRight || o == LayoutItem::RightToLeft;
+}
+
+bool LayoutPlan::isVertical (int index) const
+{
+    const LayoutItem::Orientation o = orientations.getUnchecked (index);
+    return o == LayoutItem::TopDown || o == LayoutItem::BottomUp;
+}
+
+juce::Component* LayoutPlan::getComponent (int index) const
+{
+    if (LayoutItem::SharedLayoutData* data = sharedData.getObjectPointerUnchecked (index)) {
+        return data->getComponent();
+    }
+    return nullptr;
+}
+
+juce::Rectangle<int> LayoutPlan::getItemBounds (int index) const
+{
+    return itemBounds [index];
+}
+
+const juce::Array<juce::Rectangle<int> >& LayoutPlan::getAllItemBounds () const
+{
+    return itemBounds;
+}
+
+juce::Rectangle<int> LayoutPlan::getInputBounds (int index) const
+{
+    return inputBounds [index];
+}
+
+void LayoutPlan::setItemBounds (int index, juce::Rectangle<int> bounds)
+{
+    itemBounds.set (index, bounds);
+    if (binding == WriteToNodes) {
+        // nobody can read the bounds from a temporary plan, so keep them in the node
+        nodes.getReference (index).setProperty (LayoutItem::volatileItemBounds, bounds.toString(), nullptr);
+    }
+}
+
+void LayoutPlan::setBoundsAreFinal (int index, bool final)
+{
+    boundsAreFinal.set (index, final);
+    if (!isUpdating) {
+        // set from outside a pass, the cached results didn't know about it
+        invalidateCache();
+    }
+    if (binding == WriteToNodes) {
+        LayoutItem item (nodes.getUnchecked (index));
+        item.setBoundsAreFinal (final);
+    }
+}
+
+bool LayoutPlan::getBoundsAreFinal (int index) const
+{
+    return boundsAreFinal [index];
+}
+
+void LayoutPlan::setRelativePosition (int index, float position)
+{
+    // the clamped position is kept in the plan, until the drag finishes and stores it
+    relativePositions.set (index, position);
+    if (binding == WriteToNodes) {
+        juce::ValueTree node = nodes.getUnchecked (index);
+        LayoutSplitter splitter (node);
+        splitter.setRelativePosition (position);
+    }
+}
+
+float LayoutPlan::getRelativePosition (int index) const
+{
+    return relativePositions [index];
+}
+
+juce::Rectangle<int> LayoutPlan::getPaddedItemBounds (int index) const
+{
+    const int left = paddingLeft.getUnchecked (index);
+    const int top  = paddingTop.getUnchecked (index);
+    const juce::Rectangle<int> bounds = itemBounds.getUnchecked (index);
+    return juce::Rectangle<int> (bounds.getX() + left,
+                                 bounds.getY() + top,
+                                 bounds.getWidth() - (left + paddingRight.getUnchecked (index)),
+                                 bounds.getHeight() - (top + paddingBottom.getUnchecked (index)));
+}
+
+void LayoutPlan::constrainBounds (int index, juce::Rectangle<int>& bounds, bool& changedWidth, bool& changedHeight, bool preferVertical) const
+{
+    const int cbMinWidth  = minWidths.getUnchecked (index);
+    const int cbMaxWidth  = maxWidths.getUnchecked (index);
+    const int cbMinHeight = minHeights.getUnchecked (index);
+    const int cbMaxHeight = maxHeights.getUnchecked (index);
+    const float aspectRatio = aspectRatios.getUnchecked (index);
+
+    changedWidth  = false;
+    changedHeight = false;
+
+    if (cbMaxWidth > 0 && cbMaxWidth < bounds.getWidth()) {
+        bounds.setWidth (cbMaxWidth);
+        changedWidth = true;
+    }
+    if (aspectRatio > 0.001 && !preferVertical) {
+        bounds.setWidth (bounds.getHeight() * aspectRatio);
+        changedWidth = true;
+    }
+    if (cbMinWidth > 0 && cbMinWidth > bounds.getWidth()) {
+        bounds.setWidth (cbMinWidth);
+        changedWidth = true;
+    }
+    if (cbMaxHeight > 0 && cbMaxHeight < bounds.getHeight()) {
+        bounds.setHeight (cbMaxHeight);
+        changedHeight = true;
+    }
+    if (aspectRatio > 0.001 && preferVertical) {
+        bounds.setHeight (bounds.getWidth() / aspectRatio);
+        changedHeight = true;
+    }
+    if (cbMinHeight > 0 && cbMinHeight > bounds.getHeight()) {
+        bounds.setHeight (cbMinHeight);
+        changedHeight = true;
+    }
+}
+
+void LayoutPlan::getItemStretch (int index, float& w, float& h) const
+{
+    w = childStretchX.getUnchecked (index);
+    h = childStretchY.getUnchecked (index);
+}
+
+void LayoutPlan::getStretch (int index, float& w, float& h, int start, int end) const
+{
+    if (types.getUnchecked (index) == LayoutItem::SubLayout && start <= 0 && end == numChildren.getUnchecked (index)) {
+        w = cummulatedStretchX.getUnchecked (index);
+        h = cummulatedStretchY.getUnchecked (index);
+        return;
+    }
+    computeStretch (index, w, h, start, end);
+}
+
+void LayoutPlan::computeStretch (int index, float& w, float& h, int start, int end) const
+{
+    if (types.getUnchecked (index) != LayoutItem::SubLayout) {
+        w = stretchX.getUnchecked (index);
+        h = stretchY.getUnchecked (index);
+        return;
+    }
+
+    const bool horizontal = isHorizontal (index);
+    const bool vertical   = isVertical (index);
+
+    const float itemStretchX = stretchX.getUnchecked (index);
+    const float itemStretchY = stretchY.getUnchecked (index);
+
+    w = std::max (itemStretchX, 0.0f);
+    h = std::max (itemStretchY, 0.0f);
+
+    if (w > 0.0001 && h > 0.0001) {
+        return;
+    }
+
+    const int first = firstChildren.getUnchecked (index);
+    for (int i=start; i < std::min (end, numChildren.getUnchecked (index)); ++i) {
+        const int child = first + i;
+        if (overlays.getUnchecked (child) < 1) {
+            const float x = childStretchX.getUnchecked (child);
+            const float y = childStretchY.getUnchecked (child);
+            if (horizontal) {
+                if (itemStretchX <= 0) w += x;
+                if (itemStretchY <= 0) h = std::max (h, y);
+            }
+            else if (vertical) {
+                if (itemStretchX <= 0) w = std::max (w, x);
+                if (itemStretchY <= 0) h += y;
+            }
+            else {
+                if (itemStretchX <= 0) w += x;
+                if (itemStretchY <= 0) h += y;
+            }
+        }
+    }
+
+    // no stretch in children defaults to 1.0
+    if (w <= 0.0) w = 1.0;
+    if (h <= 0.0) h = 1.0;
+}
+
+void LayoutPlan::updateStretch (int index)
+{
+    // the stretch of an item, when it is laid out as child. Like LayoutItem::getStretch
+    // called with the default range, this doesn't include the children's stretch.
+    float w, h;
+    computeStretch (index, w, h, 0, -1);
+    childStretchX.set (index, w);
+    childStretchY.set (index, h);
+
+    computeStretch (index, w, h, 0, numChildren.getUnchecked (index));
+    cummulatedStretchX.set (index, w);
+    cummulatedStretchY.set (index, h);
+}
+
+void LayoutPlan::getSizeLimits (int index, int& minW, int& maxW, int& minH, int& maxH, int start, int end) const
+{
+    const int count = numChildren.getUnchecked (index);
+    if (end < 0) {
+        end = count;
+    }
+
+    if (types.getUnchecked (index) == LayoutItem::SubLayout) {
+        SizeLimits limits;
+        limits.minW = minW;
+        limits.maxW = maxW;
+        limits.minH = minH;
+        limits.maxH = maxH;
+        const int first = firstChildren.getUnchecked (index);
+        for (int i=start; i < std::min (end, count); ++i) {
+            addSizeLimits (index, first + i, limits);
+        }
+        limits = limits.finalised();
+        minW = limits.minW;
+        maxW = limits.maxW;
+        minH = limits.minH;
+        maxH = limits.maxH;
+    }
+    else {
+        const int cMinW = minWidths.getUnchecked (index);
+        const int cMaxW = maxWidths.getUnchecked (index);
+        const int cMinH = minHeights.getUnchecked (index);
+        const int cMaxH = maxHeights.getUnchecked (index);
+        if (cMinW >= 0) { if (minW < 0) minW = cMinW; else minW = std::max (minW, cMinW); }
+        if (cMaxW >= 0) { if (maxW < 0) maxW = cMaxW; else maxW = std::min (maxW, cMaxW); }
+        if (cMinH >= 0) { if (minH < 0) minH = cMinH; else minH = std::max (minH, cMinH); }
+        if (cMaxH >= 0) { if (maxH < 0) maxH = cMaxH; else maxH = std::min (maxH, cMaxH); }
+    }
+}
+
+void LayoutPlan::addSizeLimits (int index, int child, SizeLimits& limits) const
+{
+    if (overlays.getUnchecked (child) >= 1) {
+        return;
+    }
+
+    const int cMinW = minWidths.getUnchecked (child);
+    const int cMaxW = maxWidths.getUnchecked (child);
+    const int cMinH = minHeights.getUnchecked (child);
+    const int cMaxH = maxHeights.getUnchecked (child);
+
+    if (isVertical (index)) {
+        if (cMinW >= 0) limits.minW = (limits.minW < 0) ? cMinW : juce::jmax (limits.minW, cMinW);
+        if (cMaxW >= 0) limits.maxW = (limits.maxW < 0) ? cMaxW : juce::jmin (limits.maxW, cMaxW);
+        if (cMinH >= 0) limits.minH = (limits.minH < 0) ? cMinH : limits.minH + cMinH;
+        if (cMaxH >= 0) {
+            limits.maxH = (limits.maxH < 0) ? cMaxH : limits.maxH + cMaxH;
+        }
+        else {
+            limits.canConsumeHeight = true;
+        }
+    }
+    else if (isHorizontal (index)) {
+        if (cMinW >= 0) limits.minW = (limits.minW < 0) ? cMinW : limits.minW + cMinW;
+        if (cMaxW >= 0) {
+            limits.maxW = (limits.maxW < 0) ? cMaxW : limits.maxW + cMaxW;
+        }
+        else {
+            limits.canConsumeWidth = true;
+        }
+        if (cMinH >= 0) limits.minH = (limits.minH < 0) ? cMinH : juce::jmax (limits.minH, cMinH);
+        if (cMaxH >= 0) limits.maxH = (limits.maxH < 0) ? cMaxH : juce::jmin (limits.maxH, cMaxH);
+    }
+}
+
+void LayoutPlan::updateSplitterLimits (int index)
+{
+    if (types.getUnchecked (index) != LayoutItem::SubLayout) {
+        return;
+    }
+
+    const int first = firstChildren.getUnchecked (index);
+    const int count = numChildren.getUnchecked (index);
+
+    // limits of the items between the previous splitter and each splitter,
+    // using the same scan like layoutNode
+    SizeLimits segment;
+    for (int i=0; i<count; ++i) {
+        const int child = first + i;
+        if (overlays.getUnchecked (child) < 1 && types.getUnchecked (child) == LayoutItem::SplitterItem) {
+            segmentLimits.set (child, segment.finalised());
+            segment = SizeLimits();
+            // the item after a splitter starts the next segment
+            ++i;
+            if (i < count) {
+                addSizeLimits (index, first + i, segment);
+            }
+        }
+        else {
+            addSizeLimits (index, child, segment);
+        }
+    }
+
+    // limits of each splitter and everything after it, summed from the end
+    SizeLimits remaining;
+    for (int i=count-1; i >= 0; --i) {
+        const int child = first + i;
+        addSizeLimits (index, child, remaining);
+        remainingLimits.set (child, remaining.finalised());
+    }
+}
+
+
+int LayoutPlan::updateGeometry (juce::Rectangle<int> bounds)
+{
+    return updateNodeGeometry (0, bounds);
+}
+
+int LayoutPlan::updateNodeGeometry (int index, juce::Rectangle<int> bounds)
+{
+    const int needsGrowing = computeNodeGeometry (index, bounds);
+    commitGeometry();
+    return needsGrowing;
+}
+
+int LayoutPlan::updateNodeGeometry (int index, juce::Rectangle<int> bounds, int start, int end)
+{
+    const int needsGrowing = computeNodeGeometry (index, bounds, start, end);
+    commitGeometry();
+    return needsGrowing;
+}
+
+juce::Array<juce::Rectangle<int> > LayoutPlan::computeLayout (const juce::ValueTree& root, juce::Rectangle<int> bounds, juce::Array<juce::ValueTree>* nodes)
+{
+    LayoutPlan plan;
+    plan.compile (root, Detached);
+    plan.computeGeometry (bounds);
+    if (nodes) {
+        *nodes = plan.nodes;
+    }
+    return plan.itemBounds;
+}
+
+int LayoutPlan::computeGeometry (juce::Rectangle<int> bounds)
+{
+    return computeNodeGeometry (0, bounds);
+}
+
+int LayoutPlan::computeNodeGeometry (int index, juce::Rectangle<int> bounds)
+{
+    // recursion check, a component might trigger a new pass from its resized callback
+    if (isUpdating || !juce::isPositiveAndBelow (index, nodes.size())) {
+        return 0;
+    }
+    juce::ScopedValueSetter<bool> updating (isUpdating, true);
+    if (slicing) {
+        // the sub layouts left by a sliced pass must not miss their bounds
+        layoutSlices (std::numeric_limits<double>::max());
+    }
+
+    const bool useCache = (index == 0 && cacheSize > 0);
+    if (useCache && restoreFromCache (bounds)) {
+        ++statistics.cacheHits;
+        return cache.getLast()->needsGrowing;
+    }
+
+    // a node laid out into the same bounds doesn't change anything outside of it
+    const bool sameBounds = (index > 0 && inputBounds.getUnchecked (index) == bounds);
+
+    prepareParallelPass (subtreeSizes.getUnchecked (index));
+    const int needsGrowing = layoutNode (index, bounds, pending);
+    layoutDeferred();
+
+    if (sameBounds) {
+        cleanAncestors (index);
+    }
+
+    if (useCache) {
+        ++statistics.cacheMisses;
+        addToCache (bounds, needsGrowing);
+    }
+    return needsGrowing;
+}
+
+int LayoutPlan::computeNodeGeometry (int index, juce::Rectangle<int> bounds, int start, int end)
+{
+    if (isUpdating || !juce::isPositiveAndBelow (index, nodes.size())) {
+        return 0;
+    }
+    juce::ScopedValueSetter<bool> updating (isUpdating, true);
+    if (slicing) {
+        // the sub layouts left by a sliced pass must not miss their bounds
+        layoutSlices (std::numeric_limits<double>::max());
+    }
+    prepareParallelPass (subtreeSizes.getUnchecked (index));
+    const int needsGrowing = layoutRange (index, bounds, start, end, pending);
+    layoutDeferred();
+    return needsGrowing;
+}
+
+void LayoutPlan::beginSlicedGeometry (juce::Rectangle<int> bounds, int sliceSize)
+{
+    if (isUpdating || nodes.isEmpty()) {
+        return;
+    }
+    juce::ScopedValueSetter<bool> updating (isUpdating, true);
+    if (slicing) {
+        layoutSlices (std::numeric_limits<double>::max());
+    }
+
+    // the same split into independent sub layouts as for the thread pool
+    slicing = true;
+    sliced.canDefer = true;
+    sliced.taskSize = juce::jmax (1, sliceSize);
+    layoutNode (0, bounds, sliced);
+}
+
+bool LayoutPlan::continueSlicedGeometry (double deadline)
+{
+    if (!slicing) {
+        return true;
+    }
+    if (isUpdating) {
+        return false;
+    }
+    juce::ScopedValueSetter<bool> updating (isUpdating, true);
+    return layoutSlices (deadline);
+}
+
+void LayoutPlan::cleanAncestors (int index)
+{
+    // the parents were only marked because of a change inside the node, unless
+    // they or one of the other children were changed as well
+    for (int parent = parents.getUnchecked (index); parent >= 0; parent = parents.getUnchecked (parent)) {
+        if (selfDirty.getUnchecked (parent)) {
+            return;
+        }
+        const int first = firstChildren.getUnchecked (parent);
+        for (int i=first; i < first + numChildren.getUnchecked (parent); ++i) {
+            if (dirty.getUnchecked (i) || selfDirty.getUnchecked (i)) {
+                return;
+            }
+        }
+        dirty.set (parent, false);
+    }
+}
+
+bool LayoutPlan::isSlicedGeometryPending () const
+{
+    return slicing;
+}
+
+void LayoutPlan::cancelSlicedGeometry ()
+{
+    if (!slicing || isUpdating) {
+        return;
+    }
+    slicing = false;
+    sliced.bounds.clearQuick();
+    sliced.notifications.clearQuick();
+    sliced.deferred.clearQuick();
+    sliced.deferredBoundsAt.clearQuick();
+    sliced.deferredNotificationsAt.clearQuick();
+    for (int i=0; i < dirty.size(); ++i) {
+        dirty.set (i, true);
+    }
+    invalidateCache();
+}
+
+bool LayoutPlan::layoutSlices (double deadline)
+{
+    // sub layouts deferred while computing a slice are appended and computed in this loop as well
+    int next = 0;
+    while (next < sliced.deferred.size()) {
+        if (next > 0 && juce::Time::getMillisecondCounterHiRes() >= deadline) {
+            sliced.deferred.removeRange (0, next);
+            return false;
+        }
+        const int index = sliced.deferred.getUnchecked (next++);
+        layoutNode (index, getPaddedItemBounds (index), sliced);
+    }
+
+    pending.bounds.addArray (sliced.bounds);
+    pending.notifications.addArray (sliced.notifications);
+    sliced.bounds.clearQuick();
+    sliced.notifications.clearQuick();
+    sliced.deferred.clearQuick();
+    sliced.deferredBoundsAt.clearQuick();
+    sliced.deferredNotificationsAt.clearQuick();
+    sliced.canDefer = false;
+    slicing = false;
+    return true;
+}
+
+void LayoutPlan::setCacheSize (int numEntries)
+{
+    cacheSize = juce::jmax (0, numEntries);
+    while (cache.size() > cacheSize) {
+        cache.remove (0);
+    }
+}
+
+int LayoutPlan::getCacheSize () const
+{
+    return cacheSize;
+}
+
+void LayoutPlan::invalidateCache ()
+{
+    // cached results of older revisions can't be hit anymore
+    ++revision;
+    cache.clear();
+}
+
+bool LayoutPlan::restoreFromCache (juce::Rectangle<int> bounds)
+{
+    for (int i=cache.size() - 1; i >= 0; --i) {
+        const CacheEntry* entry = cache.getUnchecked (i);
+        if (entry->revision == revision && entry->bounds == bounds) {
+            itemBounds        = entry->itemBounds;
+            inputBounds       = entry->inputBounds;
+            boundsAreFinal    = entry->boundsAreFinal;
+            relativePositions = entry->relativePositions;
+            dirty             = entry->dirty;
+            selfDirty         = entry->dirty;
+            targets           = entry->targets;
+
+            // queue everything, the commit skips what the components have already
+            for (int index=0; index < targets.size(); ++index) {
+                const CommitTarget& target = targets.getReference (index);
+                if (target.hasBounds) {
+                    pending.bounds.add (PendingBounds (index, target.bounds));
+                }
+            }
+            for (int index=0; index < targets.size(); ++index) {
+                if (targets.getReference (index).notify) {
+                    pending.notifications.add (index);
+                }
+            }
+
+            // most recently used is at the end
+            cache.move (i, cache.size() - 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void LayoutPlan::addToCache (juce::Rectangle<int> bounds, int needsGrowing)
+{
+    CacheEntry* entry = (cache.size() >= cacheSize) ? cache.removeAndReturn (0) : new CacheEntry();
+    entry->revision          = revision;
+    entry->bounds            = bounds;
+    entry->needsGrowing      = needsGrowing;
+    entry->itemBounds        = itemBounds;
+    entry->inputBounds       = inputBounds;
+    entry->boundsAreFinal    = boundsAreFinal;
+    entry->relativePositions = relativePositions;
+    entry->dirty             = dirty;
+    entry->targets           = targets;
+    cache.add (entry);
+}
+
+/**
+ The threads computing sub layouts in parallel, shared by all plans. A pass
+ borrows them only while waiting for it's own jobs.
+ */
+class LayoutPlan::WorkerPool : public juce::ThreadPool,
+                               public juce::DeletedAtShutdown
+{
+public:
+    WorkerPool ()
+      : juce::ThreadPool (juce::jmax (1, juce::SystemStats::getNumCpus() - 1))
+    {
+    }
+
+    ~WorkerPool ()
+    {
+        clearSingletonInstance();
+    }
+
+    JUCE_DECLARE_SINGLETON (WorkerPool, false)
+};
+
+JUCE_IMPLEMENT_SINGLETON (LayoutPlan::WorkerPool)
+
+void LayoutPlan::setParallelThreshold (int minNumNodes, int numThreads)
+{
+    jassert (!isUpdating);
+    parallelThreshold = juce::jmax (0, minNumNodes);
+    maxNumJobs = juce::jmax (0, numThreads);
+}
+
+int LayoutPlan::getParallelThreshold () const
+{
+    return parallelThreshold;
+}
+
+void LayoutPlan::prepareParallelPass (int numNodes)
+{
+    // writing results into the nodes is not thread safe
+    pending.canDefer = binding != WriteToNodes
+                    && parallelThreshold > 0
+                    && numNodes >= parallelThreshold;
+    if (pending.canDefer) {
+        // a few tasks per thread, so a big sub layout doesn't leave the other threads idle
+        pending.taskSize = juce::jmax (1, numNodes / (4 * (getNumJobs() + 1)));
+    }
+}
+
+int LayoutPlan::getNumJobs () const
+{
+    const int numThreads = WorkerPool::getInstance()->getNumThreads();
+    return maxNumJobs > 0 ? juce::jmin (maxNumJobs, numThreads) : numThreads;
+}
+
+/**
+ A job, that computes deferred sub layouts until none is left
+ */
+class LayoutPlan::ParallelJob : public juce::ThreadPoolJob
+{
+public:
+    ParallelJob (LayoutPlan& planToUse, juce::OwnedArray<Pass>& tasksToRun, std::atomic<int>& nextTaskToRun)
+      : juce::ThreadPoolJob ("Layout"),
+        plan (planToUse),
+        tasks (tasksToRun),
+        nextTask (nextTaskToRun)
+    {
+    }
+
+    JobStatus runJob () override
+    {
+        plan.runDeferredTasks (tasks, nextTask);
+        return jobHasFinished;
+    }
+
+private:
+    LayoutPlan&               plan;
+    juce::OwnedArray<Pass>&   tasks;
+    std::atomic<int>&         nextTask;
+
+    JUCE_DECLARE_NON_COPYABLE (ParallelJob)
+};
+
+void LayoutPlan::layoutDeferred ()
+{
+    pending.canDefer = false;
+    if (pending.deferred.isEmpty()) {
+        return;
+    }
+
+    // each sub layout writes only into it's own entries, so they can be computed independently
+    juce::OwnedArray<Pass> tasks;
+    for (int i=0; i < pending.deferred.size(); ++i) {
+        Pass* task = tasks.add (new Pass());
+        task->deferred.add (pending.deferred.getUnchecked (i));
+    }
+    pending.deferred.clearQuick();
+
+    std::atomic<int> nextTask (0);
+    juce::OwnedArray<ParallelJob> jobs;
+    juce::ThreadPool* pool = WorkerPool::getInstance();
+    const int numJobs = juce::jmin (getNumJobs(), tasks.size() - 1);
+    for (int i=0; i < numJobs; ++i) {
+        pool->addJob (jobs.add (new ParallelJob (*this, tasks, nextTask)), false);
+    }
+
+    // the calling thread takes tasks as well, instead of just waiting
+    runDeferredTasks (tasks, nextTask);
+
+    for (int i=0; i < jobs.size(); ++i) {
+        pool->waitForJobToFinish (jobs.getUnchecked (i), -1);
+    }
+
+    // splice the results in where the serial pass would have queued them, so the
+    // components are moved and notified in the same order
+    juce::Array<PendingBounds> bounds;
+    juce::Array<int> notifications;
+    int boundsFrom = 0;
+    int notificationsFrom = 0;
+    for (int i=0; i < tasks.size(); ++i) {
+        const int boundsAt = pending.deferredBoundsAt.getUnchecked (i);
+        const int notificationsAt = pending.deferredNotificationsAt.getUnchecked (i);
+        bounds.addArray (pending.bounds, boundsFrom, boundsAt - boundsFrom);
+        bounds.addArray (tasks.getUnchecked (i)->bounds);
+        notifications.addArray (pending.notifications, notificationsFrom, notificationsAt - notificationsFrom);
+        notifications.addArray (tasks.getUnchecked (i)->notifications);
+        boundsFrom = boundsAt;
+        notificationsFrom = notificationsAt;
+    }
+    bounds.addArray (pending.bounds, boundsFrom, pending.bounds.size() - boundsFrom);
+    notifications.addArray (pending.notifications, notificationsFrom, pending.notifications.size() - notificationsFrom);
+    pending.bounds.swapWith (bounds);
+    pending.notifications.swapWith (notifications);
+    pending.deferredBoundsAt.clearQuick();
+    pending.deferredNotificationsAt.clearQuick();
+}
+
+void LayoutPlan::runDeferredTasks (juce::OwnedArray<Pass>& tasks, std::atomic<int>& nextTask)
+{
+    for (int i = nextTask++; i < tasks.size(); i = nextTask++) {
+        Pass& task = *tasks.getUnchecked (i);
+        const int index = task.deferred.getUnchecked (0);
+        layoutNode (index, getPaddedItemBounds (index), task);
+    }
+}
+
+juce::Rectangle<int> LayoutPlan::commitGeometry ()
+{
+    juce::Rectangle<int> changedArea;
+    if (isUpdating) {
+        return changedArea;
+    }
+    juce::ScopedValueSetter<bool> updating (isUpdating, true);
+
+    // all geometry is computed, so components and listeners see the final state of their siblings
+    for (int i=0; i < pending.bounds.size(); ++i) {
+        const PendingBounds& item = pending.bounds.getReference (i);
+        commitBounds (item.index, item.bounds, changedArea);
+    }
+    pending.bounds.clearQuick();
+
+    for (int i=0; i < pending.notifications.size(); ++i) {
+        notifyListeners (pending.notifications.getUnchecked (i));
+    }
+    pending.notifications.clearQuick();
+
+    return changedArea;
+}
+
+bool LayoutPlan::isUpdatingGeometry () const
+{
+    return isUpdating;
+}
+
+int LayoutPlan::layoutNode (int index, juce::Rectangle<int> bounds, Pass& pass)
+{
+    int needsGrowing = 0;
+
+    if (!dirty.getUnchecked (index) && inputBounds.getUnchecked (index) == bounds) {
+        // nothing changed inside and the same space is available as in the last pass
+        return needsGrowing;
+    }
+    inputBounds.set (index, bounds);
+
+    if (types.getUnchecked (index) == LayoutItem::SubLayout) {
+        const LayoutItem::Orientation orientation = orientations.getUnchecked (index);
+        const int first = firstChildren.getUnchecked (index);
+        const int count = numChildren.getUnchecked (index);
+
+        // find splitter items
+        int last = 0;
+        juce::Rectangle<int> childBounds (bounds);
+        for (int i=0; i<count; ++i) {
+            const int child = first + i;
+            if (overlays.getUnchecked (child) < 1) {
+                if (types.getUnchecked (child) == LayoutItem::SplitterItem) {
+                    juce::Rectangle<int> splitterBounds (bounds);
+
+                    // minimum and maximum splitter positions, precomputed in updateSplitterLimits
+                    const int leftMinW  = segmentLimits.getReference (child).minW;
+                    const int leftMinH  = segmentLimits.getReference (child).minH;
+                    const int rightMinW = remainingLimits.getReference (child).minW;
+                    const int rightMinH = remainingLimits.getReference (child).minH;
+
+                    if (orientation == LayoutItem::LeftToRight) {
+                        if (bounds.getWidth() > 0) {
+                            const float relPosition = relativePositions.getUnchecked (child);
+                            const float minRelPosition = static_cast<float>(leftMinW) / bounds.getWidth();
+                            const float maxRelPosition = 1.0 - static_cast<float>(rightMinW) / bounds.getWidth();
+                            if (relPosition < minRelPosition) {
+                                setRelativePosition (child, minRelPosition);
+                            }
+                            else if (relPosition > maxRelPosition) {
+                                setRelativePosition (child, maxRelPosition);
+                            }
+                        }
+                        const int right = childBounds.getX() + relativePositions.getUnchecked (child) * bounds.getWidth();
+                        layoutRange (index, childBounds.withRight (right-1), last, i, pass);
+                        splitterBounds.setX (right-1);
+                        splitterBounds.setWidth (3);
+                        childBounds.setLeft (right+1);
+                    }
+                    else if (orientation == LayoutItem::TopDown) {
+                        if (bounds.getWidth() > 0) {
+                            const float relPosition = relativePositions.getUnchecked (child);
+                            const float minRelPosition = static_cast<float>(leftMinH) / bounds.getWidth();
+                            const float maxRelPosition = 1.0 - static_cast<float>(rightMinH) / bounds.getWidth();
+                            if (relPosition < minRelPosition) {
+                                setRelativePosition (child, minRelPosition);
+                            }
+                            else if (relPosition > maxRelPosition) {
+                                setRelativePosition (child, maxRelPosition);
+                            }
+                        }
+                        const int bottom = childBounds.getY() + relativePositions.getUnchecked (child) * bounds.getHeight();
+                        layoutRange (index, childBounds.withBottom (bottom), last, i, pass);
+                        splitterBounds.setY (bottom-1);
+                        splitterBounds.setHeight (3);
+                        childBounds.setTop (bottom+1);
+                    }
+                    else if (orientation == LayoutItem::RightToLeft) {
+                        if (bounds.getWidth() > 0) {
+                            const float relPosition = relativePositions.getUnchecked (child);
+                            const float minRelPosition = 1.0 - static_cast<float>(leftMinW) / bounds.getWidth();
+                            const float maxRelPosition = static_cast<float>(rightMinW) / bounds.getWidth();
+                            if (relPosition < minRelPosition) {
+                                setRelativePosition (child, minRelPosition);
+                            }
+                            else if (relPosition > maxRelPosition) {
+                                setRelativePosition (child, maxRelPosition);
+                            }
+                        }
+                        const int left = childBounds.getX() + relativePositions.getUnchecked (child) * bounds.getWidth();
+                        layoutRange (index, childBounds.withLeft (left), last, i, pass);
+                        splitterBounds.setX (left-1);
+                        splitterBounds.setWidth (3);
+                        childBounds.setRight (left-1);
+                    }
+                    else if (orientation == LayoutItem::BottomUp) {
+                        if (bounds.getWidth() > 0) {
+                            const float relPosition = relativePositions.getUnchecked (child);
+                            const float minRelPosition = 1.0 - static_cast<float>(leftMinH) / bounds.getWidth();
+                            const float maxRelPosition = static_cast<float>(rightMinH) / bounds.getWidth();
+                            if (relPosition < minRelPosition) {
+                                setRelativePosition (child, minRelPosition);
+                            }
+                            else if (relPosition > maxRelPosition) {
+                                setRelativePosition (child, maxRelPosition);
+                            }
+                        }
+                        const int top = childBounds.getY() + relativePositions.getUnchecked (child) * bounds.getHeight();
+                        layoutRange (index, childBounds.withTop (top), last, i, pass);
+                        splitterBounds.setY (top-1);
+                        splitterBounds.setHeight (3);
+                        childBounds.setBottom (top-1);
+                    }
+                    setItemBounds (child, splitterBounds);
+                    queueBounds (child, splitterBounds, pass);
+                    setBoundsAreFinal (child, true);
+
+                    i++;
+                    last = i;
+                }
+            }
+        }
+
+        // layout rest right of splitter, if any
+        layoutRange (index, childBounds, last, count, pass);
+    }
+    dirty.set (index, false);
+    selfDirty.set (index, false);
+
+    // items are laid out with their parent, sub layouts clear their own flags
+    const int first = firstChildren.getUnchecked (index);
+    for (int i=first; i < first + numChildren.getUnchecked (index); ++i) {
+        if (types.getUnchecked (i) != LayoutItem::SubLayout) {
+            dirty.set (i, false);
+            selfDirty.set (i, false);
+        }
+    }
+    return needsGrowing;
+}
+
+int LayoutPlan::layoutRange (int index, juce::Rectangle<int> bounds, int start, int end, Pass& pass)
+{
+    int needsGrowing = 0;
+
+    const int first = firstChildren.getUnchecked (index);
+    end = juce::jmin (numChildren.getUnchecked (index), end);
+
+    float cummulatedX, cummulatedY;
+    getStretch (index, cummulatedX, cummulatedY, start, end);
+    float availableWidth  = bounds.getWidth();
+    float availableHeight = bounds.getHeight();
+    const LayoutItem::Orientation orientation = orientations.getUnchecked (index);
+
+    if (isVertical (index)) {
+        for (int i=start; i<end; ++i) {
+            const int child = first + i;
+            if (overlays.getUnchecked (child) < 1) {
+                float sx, sy;
+                getItemStretch (child, sx, sy);
+
+                const float h = bounds.getHeight() * sy / cummulatedY;
+                juce::Rectangle<int> childBounds (bounds.getX(), bounds.getY(), bounds.getWidth(), static_cast<int>(h));
+                bool changedWidth, changedHeight;
+                constrainBounds (child, childBounds, changedWidth, changedHeight, true);
+                setItemBounds (child, childBounds);
+                if (changedHeight) {
+                    setBoundsAreFinal (child, true);
+                    availableHeight -= childBounds.getHeight();
+                    cummulatedY -= sy;
+                }
+                else {
+                    setBoundsAreFinal (child, false);
+                }
+                if (changedWidth) {
+                    availableWidth = std::max (bounds.getWidth(), childBounds.getWidth());
+                }
+            }
+        }
+        needsGrowing = std::max (static_cast<int>(-availableHeight), 0);
+
+        float y = bounds.getY();
+        if (orientation == LayoutItem::BottomUp) {
+            y = bounds.getY() + bounds.getHeight();
+        }
+        for (int i=start; i<end; ++i) {
+            const int child = first + i;
+            const int overlay = overlays.getUnchecked (child);
+
+            if (overlay == 0) {
+                if (boundsAreFinal.getUnchecked (child)) {
+                    const float h = itemBounds.getUnchecked (child).getHeight();
+                    if (orientation == LayoutItem::BottomUp) {
+                        y -= h;
+                    }
+                    setItemBounds (child, juce::Rectangle<int> (bounds.getX(), static_cast<int>(y), static_cast<int>(availableWidth), static_cast<int>(h)));
+                    layoutChild (child, pass);
+
+                    if (orientation == LayoutItem::TopDown) {
+                        y += h;
+                    }
+                }
+                else {
+                    float sx, sy;
+                    getItemStretch (child, sx, sy);
+
+                    const float h = availableHeight * sy / cummulatedY;
+                    if (orientation == LayoutItem::BottomUp) {
+                        y -= h;
+                    }
+                    setItemBounds (child, juce::Rectangle<int> (bounds.getX(), static_cast<int>(y), static_cast<int>(availableWidth), static_cast<int>(h)));
+                    layoutChild (child, pass);
+
+                    queueNotification (child, pass);
+                    if (orientation == LayoutItem::TopDown) {
+                        y += h;
+                    }
+                }
+            }
+            else {
+                // overlay other item
+                juce::Rectangle<int> overlayTarget;
+                if (overlay == 1 && i > start) {
+                    overlayTarget = itemBounds.getUnchecked (child - 1);
+                }
+                else if (overlay == 2) {
+                    overlayTarget = bounds;
+                }
+                juce::Rectangle<int> overlayBounds (0, 0,
+                                                    static_cast<int>(overlayWidths.getUnchecked (child) * overlayTarget.getWidth()),
+                                                    static_cast<int>(overlayHeights.getUnchecked (child) * overlayTarget.getHeight()));
+                bool changedWidth, changedHeight;
+                constrainBounds (child, overlayBounds, changedWidth, changedHeight, true);
+                juce::Justification j (overlayJustifications.getUnchecked (child));
+                setItemBounds (child, j.appliedToRectangle (overlayBounds, overlayTarget));
+                layoutChild (child, pass);
+
+                queueNotification (child, pass);
+            }
+        }
+    }
+    else if (isHorizontal (index)) {
+        for (int i=start; i<end; ++i) {
+            const int child = first + i;
+            if (overlays.getUnchecked (child) < 1) {
+                float sx, sy;
+                getItemStretch (child, sx, sy);
+
+                const float w = bounds.getWidth() * sx / cummulatedX;
+                juce::Rectangle<int> childBounds (bounds.getX(), bounds.getY(), static_cast<int>(w), bounds.getHeight());
+                bool changedWidth, changedHeight;
+                constrainBounds (child, childBounds, changedWidth, changedHeight, false);
+                setItemBounds (child, childBounds);
+                if (changedWidth) {
+                    setBoundsAreFinal (child, true);
+                    availableWidth -= childBounds.getWidth();
+                    cummulatedX -= sx;
+                }
+                else {
+                    setBoundsAreFinal (child, false);
+                }
+                if (changedHeight) {
+                    availableHeight = std::max (bounds.getHeight(), childBounds.getHeight());
+                }
+            }
+        }
+        needsGrowing = std::max (static_cast<int>(-availableWidth), 0);
+
+        float x = bounds.getX();
+        if (orientation == LayoutItem::RightToLeft) {
+            x = bounds.getX() + bounds.getWidth();
+        }
+        for (int i=start; i<end; ++i) {
+            const int child = first + i;
+            const int overlay = overlays.getUnchecked (child);
+
+            if (overlay < 1) {
+                if (boundsAreFinal.getUnchecked (child)) {
+                    const float w = itemBounds.getUnchecked (child).getWidth();
+                    if (orientation == LayoutItem::RightToLeft) {
+                        x -= w;
+                    }
+                    setItemBounds (child, juce::Rectangle<int> (static_cast<int>(x), bounds.getY(), static_cast<int>(w), static_cast<int>(availableHeight)));
+                    layoutChild (child, pass);
+
+                    if (orientation == LayoutItem::LeftToRight) {
+                        x += w;
+                    }
+                }
+                else {
+                    float sx, sy;
+                    getItemStretch (child, sx, sy);
+
+                    const float w = availableWidth * sx / cummulatedX;
+                    if (orientation == LayoutItem::RightToLeft) {
+                        x -= w;
+                    }
+                    setItemBounds (child, juce::Rectangle<int> (static_cast<int>(x), bounds.getY(), static_cast<int>(w), static_cast<int>(availableHeight)));
+                    layoutChild (child, pass);
+
+                    queueNotification (child, pass);
+                    if (orientation == LayoutItem::LeftToRight) {
+                        x += w;
+                    }
+                }
+            }
+            else {
+                // overlay other item
+                juce::Rectangle<int> overlayTarget;
+                if (overlay == 1 && i > start) {
+                    overlayTarget = itemBounds.getUnchecked (child - 1);
+                }
+                else if (overlay == 2) {
+                    overlayTarget = bounds;
+                }
+                juce::Rectangle<int> overlayBounds (0, 0,
+                                                    static_cast<int>(overlayWidths.getUnchecked (child) * overlayTarget.getWidth()),
+                                                    static_cast<int>(overlayHeights.getUnchecked (child) * overlayTarget.getHeight()));
+                bool changedWidth, changedHeight;
+                constrainBounds (child, overlayBounds, changedWidth, changedHeight, true);
+                juce::Justification j (overlayJustifications.getUnchecked (child));
+                setItemBounds (child, j.appliedToRectangle (overlayBounds, overlayTarget));
+                layoutChild (child, pass);
+
+                queueNotification (child, pass);
+            }
+        }
+    }
+
+    return needsGrowing;
+}
+
+void LayoutPlan::layoutChild (int index, Pass& pass)
+{
+    if (types.getUnchecked (index) == LayoutItem::SubLayout) {
+        if (pass.canDefer && isDeferrable (index, pass)) {
+            // computed later together with it's siblings on the thread pool
+            pass.deferred.add (index);
+            pass.deferredBoundsAt.add (pass.bounds.size());
+            pass.deferredNotificationsAt.add (pass.notifications.size());
+        }
+        else {
+            layoutNode (index, getPaddedItemBounds (index), pass);
+        }
+        // component in a layout is a GroupComponent, so don't pad component but contents
+        queueBounds (index, itemBounds.getUnchecked (index), pass);
+    }
+    else {
+        queueBounds (index, getPaddedItemBounds (index), pass);
+    }
+}
+
+bool LayoutPlan::isDeferrable (int index, const Pass& pass) const
+{
+    // bigger sub layouts are split further, tiny ones are not worth a task
+    const int size = subtreeSizes.getUnchecked (index);
+    return size <= pass.taskSize && size >= juce::jmax (2, pass.taskSize / 4);
+}
+
+void LayoutPlan::queueBounds (int index, juce::Rectangle<int> bounds, Pass& pass)
+{
+    // a detached plan has nobody to apply the bounds to
+    if (binding != Detached) {
+        pass.bounds.add (PendingBounds (index, bounds));
+        CommitTarget& target = targets.getReference (index);
+        target.bounds = bounds;
+        target.hasBounds = true;
+    }
+}
+
+void LayoutPlan::queueNotification (int index, Pass& pass)
+{
+    if (binding != Detached) {
+        pass.notifications.add (index);
+        targets.getReference (index).notify = true;
+    }
+}
+
+void LayoutPlan::commitBounds (int index, juce::Rectangle<int> bounds, juce::Rectangle<int>& changedArea)
+{
+    if (juce::Component* c = getComponent (index)) {
+        CommittedState& state = committed.getReference (index);
+        if (state.hasBounds && state.bounds == bounds) {
+            ++statistics.skippedBounds;
+            return;
+        }
+        changedArea = changedArea.getUnion (c->getBounds()).getUnion (bounds);
+        c->setBounds (bounds);
+        state.bounds = bounds;
+        state.hasBounds = true;
+        ++statistics.appliedBounds;
+    }
+}
+
+void LayoutPlan::notifyListeners (int index)
+{
+    LayoutItem::SharedLayoutData* data = sharedData.getObjectPointerUnchecked (index);
+    if (data == nullptr || !data->hasListeners()) {
+        // nobody to tell, a listener added later is notified in the next pass
+        return;
+    }
+
+    const juce::Rectangle<int> bounds = getPaddedItemBounds (index);
+    CommittedState& state = committed.getReference (index);
+    if (state.hasNotified && state.notified == bounds) {
+        ++statistics.skippedNotifications;
+        return;
+    }
+    data->callListenersCallback (nodes.getUnchecked (index), bounds);
+    state.notified = bounds;
+    state.hasNotified = true;
+    ++statistics.sentNotifications;
+}
+
+const LayoutPlan::Statistics& LayoutPlan::getStatistics () const
+{
+    return statistics;
+}
+
+void LayoutPlan::resetStatistics ()
+{
+    statistics = Statistics();
+}
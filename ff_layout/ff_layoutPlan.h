@@ -0,0 +1,583 @@
+/*
+  ==============================================================================
+
+  Copyright (c) 2016 - 2017, Daniel Walz
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without modification,
+  are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+     list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors
+     may be used to endorse or promote products derived from this software without
+     specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+  INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+  OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+  OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    ff_layoutPlan.h
+    Created: 17 Oct 2026 9:30:12am
+
+  ==============================================================================
+*/
+
+#pragma once
+
+
+#include "ff_layoutItem.h"
+
+//==============================================================================
+/**
+ A LayoutPlan is the compiled form of a layout ValueTree. The tree is flattened
+ into contiguous arrays in breadth first order, so the children of each sub layout
+ occupy a consecutive range of indices. All properties needed to compute the
+ geometry are read once into typed arrays, so a layout pass doesn't need to look
+ up properties in the ValueTree.
+
+ The Layout compiles its plan in Layout::realize() and compiles it again, when
+ the state was changed.
+
+ @see Layout::updateGeometry
+ */
+class LayoutPlan
+{
+public:
+    LayoutPlan ();
+    ~LayoutPlan ();
+
+    /**
+     How the plan is connected to the nodes it was compiled from
+     */
+    enum Binding
+    {
+        BindToNodes = 0,    /**< the plan is registered at the root node, so LayoutItem::getItemBounds reads from the plan */
+        WriteToNodes,       /**< the computed bounds are written as properties into the nodes */
+        Detached            /**< the nodes are not touched at all, the results are only available from the plan */
+    };
+
+    /**
+     Flatten the tree under root into the typed arrays. Only children of sub
+     layouts are compiled, like in the recursive LayoutItem methods.
+     */
+    void compile (const juce::ValueTree& root, Binding binding=BindToNodes);
+
+    /**
+     Compute the geometry of the layout tree under root without touching any
+     component or the tree itself. The returned bounds are in the order of the
+     plan, i.e. breadth first, starting with root. If nodes is given, it is
+     filled with the corresponding nodes.
+     The tree is only read while compiling, so the computation can run on any
+     thread, as long as the tree is not changed meanwhile.
+     */
+    static juce::Array<juce::Rectangle<int> > computeLayout (const juce::ValueTree& root,
+                                                             juce::Rectangle<int> bounds,
+                                                             juce::Array<juce::ValueTree>* nodes=nullptr);
+
+    /** Compile the plan again from the last root, if it was invalidated */
+    void ensureCompiled ();
+
+    /**
+     Mark the plan as outdated, so it will be compiled again before the next pass.
+     The compiled data is kept until then, so this is safe to call during a pass.
+     */
+    void invalidate ();
+
+    /** Returns true, if the plan was compiled and not invalidated since */
+    bool isCompiled () const;
+
+    /**
+     Read the properties of a changed node again and mark it and it's parents
+     for relayout.
+     */
+    void nodeChanged (const juce::ValueTree& node);
+
+    /**
+     Mark a node and it's parents for relayout. Sub layouts, that are not marked
+     and get the same bounds like in the previous pass, are skipped.
+     */
+    void markDirty (const juce::ValueTree& node);
+
+    /**
+     While many nodes are changed at once, e.g. when binding the components, the
+     stretch factors and splitter limits are updated only once in endNodeChanges,
+     instead of summing up the siblings again for each changed node. Calls nest.
+     */
+    void beginNodeChanges ();
+
+    /** Update the stretch factors and limits of nodes changed since beginNodeChanges */
+    void endNodeChanges ();
+
+    /** Returns the number of compiled nodes */
+    int getNumNodes () const;
+
+    /** Returns the ValueTree node the entry at index was compiled from */
+    juce::ValueTree getNode (int index) const;
+
+    /**
+     Compute the geometry of the root node and all sub layouts and set the
+     bounds to the components.
+     */
+    int updateGeometry (juce::Rectangle<int> bounds);
+
+    /**
+     Compute the geometry of the node at index and all sub layouts below.
+     */
+    int updateNodeGeometry (int index, juce::Rectangle<int> bounds);
+
+    /**
+     Compute the geometry of the node's children from start to end only.
+     @see LayoutItem::updateGeometry
+     */
+    int updateNodeGeometry (int index, juce::Rectangle<int> bounds, int start, int end);
+
+    /**
+     Compute the geometry of the root node and all sub layouts without touching
+     any component. The results are kept until commitGeometry is called.
+     */
+    int computeGeometry (juce::Rectangle<int> bounds);
+
+    /** Compute the geometry of the node at index without touching any component */
+    int computeNodeGeometry (int index, juce::Rectangle<int> bounds);
+
+    /** Compute the geometry of the node's children from start to end without touching any component */
+    int computeNodeGeometry (int index, juce::Rectangle<int> bounds, int start, int end);
+
+    /**
+     Start a pass of the whole layout, that is computed in slices, e.g. to spread
+     a huge layout over several frames. Sub layouts of up to sliceSize nodes are
+     left for continueSlicedGeometry, the rest is computed right away.
+     */
+    void beginSlicedGeometry (juce::Rectangle<int> bounds, int sliceSize);
+
+    /**
+     Compute the sub layouts left by beginSlicedGeometry until the deadline in
+     juce::Time::getMillisecondCounterHiRes is reached, but at least one. Returns
+     true, when the pass is complete and can be committed.
+     */
+    bool continueSlicedGeometry (double deadline);
+
+    /**
+     Returns true, if a sliced pass was started and is not complete. Compiling the
+     plan drops an incomplete pass, any other pass completes it first.
+     */
+    bool isSlicedGeometryPending () const;
+
+    /**
+     Drop an incomplete sliced pass, e.g. because it was started with outdated
+     bounds. The part computed so far was never committed, so the next pass
+     computes all nodes again.
+     */
+    void cancelSlicedGeometry ();
+
+    /**
+     Apply the computed bounds to the components in one sweep and notify the
+     listeners afterwards. Returns the area of all components, that were moved or
+     resized, in the coordinates of the owning component.
+     */
+    juce::Rectangle<int> commitGeometry ();
+
+    /**
+     Returns the bounds a node was laid out into in the last pass, or an empty
+     rectangle, if it wasn't laid out yet.
+     */
+    juce::Rectangle<int> getInputBounds (int index) const;
+
+    /** Returns the bounds computed in the last pass */
+    juce::Rectangle<int> getItemBounds (int index) const;
+
+    /** Returns the bounds of all nodes computed in the last pass in the order of the plan */
+    const juce::Array<juce::Rectangle<int> >& getAllItemBounds () const;
+
+    /** Set the bounds of a node, e.g. a fixed position of the root node */
+    void setItemBounds (int index, juce::Rectangle<int> bounds);
+
+    /**
+     Set, if the size of a node was fixed by it's limits in the current pass. This
+     is kept in the plan only, so a layout pass doesn't change the ValueTree.
+     */
+    void setBoundsAreFinal (int index, bool final);
+
+    /** Returns true, if the size of the node was fixed by it's limits in the last pass */
+    bool getBoundsAreFinal (int index) const;
+
+    /**
+     Returns the splitter position used in the last pass. It can differ from the
+     property in the node, if the splitter had to be moved to respect the size
+     limits of the neighbouring items, until Layout::storeSplitterPosition writes
+     it back at the end of a drag.
+     */
+    float getRelativePosition (int index) const;
+
+    /**
+     Returns the plan a node was compiled into and sets index to the node's
+     position in the plan. Returns nullptr, if the node is not bound to a plan.
+     */
+    static LayoutPlan* getPlanForNode (const juce::ValueTree& node, int& index);
+
+    /** Call nodeChanged of all plans, the node is bound to */
+    static void nodeChangedInAllPlans (const juce::ValueTree& node);
+
+    /**
+     Returns the position of the node in this plan, or -1 if it was not compiled
+     into it. The index is found by following the node's parents, the plan doesn't
+     need to be bound to the nodes.
+     */
+    int getIndexOfNode (const juce::ValueTree& node) const;
+
+    /**
+     Keep the results of the last numEntries passes of the whole layout. A pass
+     with the same bounds and no change to the tree since, only commits the cached
+     result instead of computing it again. Set 0 to disable the cache, which is
+     the default. The hits and misses are counted in the Statistics.
+     */
+    void setCacheSize (int numEntries);
+
+    /** Returns the number of cached results @see setCacheSize */
+    int getCacheSize () const;
+
+    /**
+     Compute independent sub layouts in parallel, if the computed node has at
+     least minNumNodes nodes below. Set minNumNodes to 0 to compute always on the
+     calling thread, which is the default. The work is handed to one thread pool
+     shared by all plans, numThreads limits the number of pool threads a pass
+     borrows, 0 uses as many as the pool has. The results are identical to the
+     serial computation.
+
+     For small sub layouts handing out the jobs costs more than computing them, so
+     measure your layout before enabling. The module built with FF_LAYOUT_BENCHMARKS
+     contains a benchmark timing a large layout with 1..N threads.
+     */
+    void setParallelThreshold (int minNumNodes, int numThreads=0);
+
+    /** Returns the minimum number of nodes to compute in parallel, 0 if disabled */
+    int getParallelThreshold () const;
+
+    /** Returns true, while a layout pass is running */
+    bool isUpdatingGeometry () const;
+
+    /**
+     Returns true, if the property is written by the layout pass itself and needs
+     no recompile when it changes
+     */
+    static bool isComputedProperty (const juce::Identifier& property);
+
+    /**
+     Counters how many component bounds and listener notifications were applied
+     or skipped, because the geometry didn't change since the last pass.
+     */
+    struct Statistics
+    {
+        Statistics () : appliedBounds (0), skippedBounds (0), sentNotifications (0), skippedNotifications (0), cacheHits (0), cacheMisses (0), coalescedUpdates (0) {}
+
+        juce::int64 appliedBounds;
+        juce::int64 skippedBounds;
+        juce::int64 sentNotifications;
+        juce::int64 skippedNotifications;
+        juce::int64 cacheHits;
+        juce::int64 cacheMisses;
+
+        /** passes saved by Layout::triggerUpdate, the plan itself leaves it 0 */
+        juce::int64 coalescedUpdates;
+    };
+
+    /** Returns the counters since the last call to resetStatistics */
+    const Statistics& getStatistics () const;
+
+    /** Reset all counters to zero */
+    void resetStatistics ();
+
+private:
+
+    /**
+     Accumulated size limits of a range of items, -1 means no limit
+     */
+    struct SizeLimits
+    {
+        SizeLimits () : minW (-1), maxW (-1), minH (-1), maxH (-1), canConsumeWidth (false), canConsumeHeight (false) {}
+
+        /** Returns the limits, where a maximum is dropped, if any item can consume more space */
+        SizeLimits finalised () const
+        {
+            SizeLimits limits (*this);
+            if (canConsumeWidth)  limits.maxW = -1;
+            if (canConsumeHeight) limits.maxH = -1;
+            return limits;
+        }
+
+        int  minW;
+        int  maxW;
+        int  minH;
+        int  maxH;
+        bool canConsumeWidth;
+        bool canConsumeHeight;
+    };
+
+    /**
+     The bounds last set to the component and sent to the listeners of a node
+     */
+    struct CommittedState
+    {
+        CommittedState () : hasBounds (false), hasNotified (false) {}
+
+        juce::Rectangle<int> bounds;
+        juce::Rectangle<int> notified;
+        bool hasBounds;
+        bool hasNotified;
+    };
+
+    /**
+     Bounds computed for a component, waiting to be committed
+     */
+    struct PendingBounds
+    {
+        PendingBounds () : index (-1) {}
+        PendingBounds (int i, juce::Rectangle<int> b) : index (i), bounds (b) {}
+
+        int                  index;
+        juce::Rectangle<int> bounds;
+    };
+
+    /**
+     The results of a computation, that are waiting to be committed. Each thread
+     computing sub layouts in parallel collects it's results in it's own Pass.
+     */
+    struct Pass
+    {
+        Pass () : canDefer (false), taskSize (0) {}
+
+        juce::Array<PendingBounds>  bounds;
+        juce::Array<int>            notifications;
+        juce::Array<int>            deferred;
+        juce::Array<int>            deferredBoundsAt;           // where the results of a deferred
+        juce::Array<int>            deferredNotificationsAt;    // sub layout belong in serial order
+        bool                        canDefer;
+        int                         taskSize;
+    };
+
+    class ParallelJob;
+    class WorkerPool;
+
+    /**
+     The bounds last queued for a node, so a cached result can be committed
+     */
+    struct CommitTarget
+    {
+        CommitTarget () : hasBounds (false), notify (false) {}
+
+        juce::Rectangle<int> bounds;
+        bool hasBounds;
+        bool notify;
+    };
+
+    /**
+     The state of the plan after a pass of the whole layout
+     */
+    struct CacheEntry
+    {
+        CacheEntry () : revision (0), needsGrowing (0) {}
+
+        juce::int64                         revision;
+        juce::Rectangle<int>                bounds;
+        int                                 needsGrowing;
+        juce::Array<juce::Rectangle<int> >  itemBounds;
+        juce::Array<juce::Rectangle<int> >  inputBounds;
+        juce::Array<bool>                   boundsAreFinal;
+        juce::Array<float>                  relativePositions;
+        juce::Array<bool>                   dirty;
+        juce::Array<CommitTarget>           targets;
+    };
+
+    /** @internal */
+    void addNode (const juce::ValueTree& node, int parent);
+
+    /** @internal */
+    void readNode (int index);
+
+    /** @internal */
+    void markDirty (int index);
+
+    /** @internal */
+    void cleanAncestors (int index);
+
+    /** @internal */
+    int layoutNode (int index, juce::Rectangle<int> bounds, Pass& pass);
+
+    /** @internal */
+    int layoutRange (int index, juce::Rectangle<int> bounds, int start, int end, Pass& pass);
+
+    /** @internal */
+    void layoutChild (int index, Pass& pass);
+
+    /** @internal */
+    bool isDeferrable (int index, const Pass& pass) const;
+
+    /** @internal */
+    void queueBounds (int index, juce::Rectangle<int> bounds, Pass& pass);
+
+    /** @internal */
+    void queueNotification (int index, Pass& pass);
+
+    /** @internal */
+    bool layoutSlices (double deadline);
+
+    /** @internal */
+    void invalidateCache ();
+
+    /** @internal */
+    bool restoreFromCache (juce::Rectangle<int> bounds);
+
+    /** @internal */
+    void addToCache (juce::Rectangle<int> bounds, int needsGrowing);
+
+    /** @internal */
+    void prepareParallelPass (int numNodes);
+
+    /** @internal */
+    int getNumJobs () const;
+
+    /** @internal */
+    void layoutDeferred ();
+
+    /** @internal */
+    void runDeferredTasks (juce::OwnedArray<Pass>& tasks, std::atomic<int>& nextTask);
+
+    /** @internal */
+    void commitBounds (int index, juce::Rectangle<int> bounds, juce::Rectangle<int>& changedArea);
+
+    /** @internal */
+    void notifyListeners (int index);
+
+    /** @internal */
+    void getStretch (int index, float& w, float& h, int start, int end) const;
+
+    /** @internal */
+    void getItemStretch (int index, float& w, float& h) const;
+
+    /** @internal */
+    void computeStretch (int index, float& w, float& h, int start, int end) const;
+
+    /** @internal */
+    void updateStretch (int index);
+
+    /** @internal */
+    void getSizeLimits (int index, int& minW, int& maxW, int& minH, int& maxH, int start, int end) const;
+
+    /** @internal */
+    void addSizeLimits (int index, int child, SizeLimits& limits) const;
+
+    /** @internal */
+    void updateSplitterLimits (int index);
+
+    /** @internal */
+    void constrainBounds (int index, juce::Rectangle<int>& bounds, bool& changedWidth, bool& changedHeight, bool preferVertical) const;
+
+    /** @internal */
+    void setRelativePosition (int index, float position);
+
+    /** @internal */
+    juce::Rectangle<int> getPaddedItemBounds (int index) const;
+
+    /** @internal */
+    juce::Component* getComponent (int index) const;
+
+    /** @internal */
+    bool isHorizontal (int index) const;
+
+    /** @internal */
+    bool isVertical (int index) const;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LayoutPlan)
+
+    /** @internal */
+    void unbindRoot ();
+
+    juce::ValueTree root;
+    juce::ValueTree boundRoot;
+    bool compiled;
+    Binding binding;
+    bool isUpdating;
+    int nodeChangeDepth;
+    bool aggregatesPending;
+
+    // tree structure
+    juce::Array<juce::ValueTree>                nodes;
+    juce::Array<int>                            parents;
+    juce::Array<int>                            firstChildren;
+    juce::Array<int>                            numChildren;
+
+    // typed properties
+    juce::Array<LayoutItem::ItemType>           types;
+    juce::Array<LayoutItem::Orientation>        orientations;
+    juce::Array<float>                          stretchX;
+    juce::Array<float>                          stretchY;
+    juce::Array<int>                            minWidths;
+    juce::Array<int>                            maxWidths;
+    juce::Array<int>                            minHeights;
+    juce::Array<int>                            maxHeights;
+    juce::Array<float>                          aspectRatios;
+    juce::Array<int>                            paddingTop;
+    juce::Array<int>                            paddingLeft;
+    juce::Array<int>                            paddingRight;
+    juce::Array<int>                            paddingBottom;
+    juce::Array<int>                            overlays;
+    juce::Array<float>                          overlayWidths;
+    juce::Array<float>                          overlayHeights;
+    juce::Array<int>                            overlayJustifications;
+    juce::Array<float>                          relativePositions;
+    juce::ReferenceCountedArray<LayoutItem::SharedLayoutData> sharedData;
+
+    // aggregated stretch, updated when a node or one of it's children change
+    juce::Array<float>                          childStretchX;
+    juce::Array<float>                          childStretchY;
+    juce::Array<float>                          cummulatedStretchX;
+    juce::Array<float>                          cummulatedStretchY;
+
+    // size limits left and right of each splitter, updated when a child changes
+    juce::Array<SizeLimits>                     segmentLimits;
+    juce::Array<SizeLimits>                     remainingLimits;
+
+    // computed in each pass
+    juce::Array<juce::Rectangle<int> >          itemBounds;
+    juce::Array<bool>                           boundsAreFinal;
+
+    // cache to skip unchanged sub layouts
+    juce::Array<bool>                           dirty;
+    juce::Array<bool>                           selfDirty;
+    juce::Array<juce::Rectangle<int> >          inputBounds;
+
+    // what was applied to components and listeners, to skip unchanged items
+    juce::Array<CommittedState>                 committed;
+    Pass                                        pending;
+    juce::Array<CommitTarget>                   targets;
+
+    // a pass spread over several calls
+    Pass                                        sliced;
+    bool                                        slicing;
+
+    // results of previous passes, most recently used last
+    juce::int64                                 revision;
+    int                                         cacheSize;
+    juce::OwnedArray<CacheEntry>                cache;
+
+    // computing independent sub layouts in parallel
+    juce::Array<int>                            subtreeSizes;
+    int                                         parallelThreshold;
+    int                                         maxNumJobs;
+    Statistics                                  statistics;
+};
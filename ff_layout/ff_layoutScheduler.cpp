@@ -0,0 +1,235 @@
+/*
+  ==============================================================================
+
+  Copyright (c) 2016 - 2017, Daniel Walz
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without modification,
+  are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+     list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors
+     may be used to endorse or promote products derived from this software without
+     specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+  INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+  OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+  OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    ff_layoutScheduler.cpp
+    Created: 17 Oct 2026 10:52:40pm
+
+  ==============================================================================
+*/
+
+
+#include "ff_layout.h"
+
+JUCE_IMPLEMENT_SINGLETON (LayoutScheduler)
+
+LayoutScheduler::LayoutScheduler ()
+  : nextSequence (0),
+    frameBudget (4.0),
+    frameRate (60),
+    sliceSize (0),
+    overrunFrames (0)
+{
+}
+
+LayoutScheduler::~LayoutScheduler ()
+{
+    stopTimer();
+    clearSingletonInstance();
+}
+
+bool LayoutScheduler::schedule (Layout* layout)
+{
+    JUCE_ASSERT_MESSAGE_MANAGER_IS_LOCKED
+    if (layout == nullptr) {
+        return false;
+    }
+    const int index = indexOf (layout);
+    if (index >= 0) {
+        // a sliced pass in progress might use outdated input, so run it again afterwards
+        ScheduledLayout& entry = scheduled.getReference (index);
+        if (entry.inProgress) {
+            entry.retrigger = true;
+        }
+        return false;
+    }
+    ScheduledLayout entry;
+    entry.layout = layout;
+    entry.sequence = nextSequence++;
+    scheduled.add (entry);
+    if (!isTimerRunning()) {
+        startTimerHz (frameRate);
+    }
+    return true;
+}
+
+bool LayoutScheduler::remove (Layout* layout)
+{
+    const int index = indexOf (layout);
+    if (index < 0) {
+        return false;
+    }
+    scheduled.remove (index);
+    return true;
+}
+
+bool LayoutScheduler::isScheduled (const Layout* layout) const
+{
+    return indexOf (layout) >= 0;
+}
+
+void LayoutScheduler::flush ()
+{
+    while (!scheduled.isEmpty()) {
+        // removed before the update, so the layout can schedule itself again
+        const ScheduledLayout entry = scheduled.getReference (0);
+        scheduled.remove (0);
+        if (entry.layout != nullptr) {
+            entry.layout->performScheduledUpdate (std::numeric_limits<double>::max(), 0);
+        }
+        if (entry.retrigger && entry.layout != nullptr) {
+            schedule (entry.layout);
+        }
+    }
+    stopTimer();
+}
+
+void LayoutScheduler::setFrameBudget (double milliseconds)
+{
+    frameBudget = juce::jmax (0.0, milliseconds);
+}
+
+double LayoutScheduler::getFrameBudget () const
+{
+    return frameBudget;
+}
+
+void LayoutScheduler::setFrameRate (int framesPerSecond)
+{
+    frameRate = juce::jmax (1, framesPerSecond);
+    if (isTimerRunning()) {
+        startTimerHz (frameRate);
+    }
+}
+
+int LayoutScheduler::getFrameRate () const
+{
+    return frameRate;
+}
+
+void LayoutScheduler::setSliceSize (int numNodes)
+{
+    sliceSize = juce::jmax (0, numNodes);
+}
+
+int LayoutScheduler::getSliceSize () const
+{
+    return sliceSize;
+}
+
+juce::int64 LayoutScheduler::getNumOverrunFrames () const
+{
+    return overrunFrames;
+}
+
+void LayoutScheduler::timerCallback ()
+{
+    const double deadline = juce::Time::getMillisecondCounterHiRes() + frameBudget;
+    sortSchedule();
+
+    while (!scheduled.isEmpty()) {
+        // removed before the update, so the layout can schedule itself again
+        ScheduledLayout entry = scheduled.getReference (0);
+        scheduled.remove (0);
+        if (entry.layout == nullptr) {
+            continue;
+        }
+        if (!entry.layout->performScheduledUpdate (deadline, sliceSize)) {
+            // an unfinished layout is pinned in front, so it's continued in the next frame
+            if (entry.layout != nullptr) {
+                // a layout scheduled during the slice is updated again after the pass
+                if (remove (entry.layout)) {
+                    entry.retrigger = true;
+                }
+                entry.inProgress = true;
+                scheduled.insert (0, entry);
+            }
+            break;
+        }
+        if (entry.retrigger && entry.layout != nullptr) {
+            schedule (entry.layout);
+        }
+        if (juce::Time::getMillisecondCounterHiRes() >= deadline) {
+            break;
+        }
+    }
+
+    if (scheduled.isEmpty()) {
+        stopTimer();
+    }
+    else {
+        ++overrunFrames;
+    }
+}
+
+int LayoutScheduler::indexOf (const Layout* layout) const
+{
+    for (int i=0; i < scheduled.size(); ++i) {
+        if (scheduled.getReference (i).layout.get() == layout) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void LayoutScheduler::sortSchedule ()
+{
+    for (int i=0; i < scheduled.size(); ++i) {
+        ScheduledLayout& entry = scheduled.getReference (i);
+        if (Layout* layout = entry.layout) {
+            const juce::Component* owner = layout->getOwningComponent();
+            entry.showing  = owner != nullptr && owner->isShowing();
+            entry.priority = layout->getSchedulingPriority();
+        }
+    }
+    ScheduleSorter sorter;
+    scheduled.sort (sorter, true);
+}
+
+int LayoutScheduler::ScheduleSorter::compareElements (const ScheduledLayout& first, const ScheduledLayout& second)
+{
+    // a half computed layout first, then visible layouts, then by priority, then in
+    // the order they were scheduled
+    if (first.inProgress != second.inProgress) {
+        return first.inProgress ? -1 : 1;
+    }
+    if (first.showing != second.showing) {
+        return first.showing ? -1 : 1;
+    }
+    if (first.priority != second.priority) {
+        return first.priority > second.priority ? -1 : 1;
+    }
+    if (first.sequence != second.sequence) {
+        return first.sequence < second.sequence ? -1 : 1;
+    }
+    return 0;
+}
@@ -0,0 +1,148 @@
+/*
+  ==============================================================================
+
+  Copyright (c) 2016 - 2017, Daniel Walz
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without modification,
+  are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+     list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors
+     may be used to endorse or promote products derived from this software without
+     specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+  INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+  OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+  OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    ff_layoutScheduler.h
+    Created: 17 Oct 2026 10:52:40pm
+
+  ==============================================================================
+*/
+
+#pragma once
+
+
+class Layout;
+
+//==============================================================================
+/**
+ The LayoutScheduler performs the updates of all layouts, that were switched to
+ scheduled updates with Layout::setUsesScheduler, once per frame on the message
+ thread. Instead of computing all dirty layouts in the same message callback, e.g.
+ when the scale factor changed for all open windows, it computes them ordered by
+ visibility and priority until the frame budget is spent and continues with the
+ rest in the next frame.
+
+ Layouts with more nodes than the slice size are computed in slices, so even a
+ single huge layout doesn't block the message thread for longer than a frame.
+
+ @see Layout::setUsesScheduler
+ */
+class LayoutScheduler : private juce::Timer,
+                        public juce::DeletedAtShutdown
+{
+public:
+    LayoutScheduler ();
+    ~LayoutScheduler ();
+
+    JUCE_DECLARE_SINGLETON (LayoutScheduler, false)
+
+    /**
+     Add a layout to be updated in the next frame. Returns false, if it was already
+     scheduled, so the update is coalesced with the scheduled one.
+     */
+    bool schedule (Layout* layout);
+
+    /**
+     Remove a layout from the schedule. Returns true, if it was scheduled.
+     */
+    bool remove (Layout* layout);
+
+    /** Returns true, if the layout is waiting for it's update */
+    bool isScheduled (const Layout* layout) const;
+
+    /** Perform all scheduled updates now, regardless of the budget */
+    void flush ();
+
+    /**
+     Set the time in milliseconds, that is spent on layout updates per frame. At
+     least one update or slice is computed per frame. The default is 4 ms.
+     */
+    void setFrameBudget (double milliseconds);
+
+    /** Returns the time in milliseconds spent per frame @see setFrameBudget */
+    double getFrameBudget () const;
+
+    /** Set how often the scheduled updates are performed. The default is 60 Hz */
+    void setFrameRate (int framesPerSecond);
+
+    /** Returns the frames per second @see setFrameRate */
+    int getFrameRate () const;
+
+    /**
+     Layouts with more than numNodes nodes are computed in slices of about that
+     size, which can be spread over several frames. Set 0 to compute each layout
+     in one go, which is the default.
+     */
+    void setSliceSize (int numNodes);
+
+    /** Returns the size of the slices @see setSliceSize */
+    int getSliceSize () const;
+
+    /** Returns the number of frames, that ran out of budget before all scheduled updates were done */
+    juce::int64 getNumOverrunFrames () const;
+
+    /** @internal */
+    void timerCallback () override;
+
+private:
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LayoutScheduler)
+
+    struct ScheduledLayout
+    {
+        ScheduledLayout () : sequence (0), showing (false), priority (0), inProgress (false), retrigger (false) {}
+
+        juce::WeakReference<Layout> layout;
+        juce::int64                 sequence;
+        bool                        showing;
+        int                         priority;
+        bool                        inProgress;
+        bool                        retrigger;
+    };
+
+    struct ScheduleSorter
+    {
+        static int compareElements (const ScheduledLayout& first, const ScheduledLayout& second);
+    };
+
+    /** @internal */
+    int indexOf (const Layout* layout) const;
+
+    /** @internal */
+    void sortSchedule ();
+
+    juce::Array<ScheduledLayout>    scheduled;
+    juce::int64                     nextSequence;
+    double                          frameBudget;
+    int                             frameRate;
+    int                             sliceSize;
+    juce::int64                     overrunFrames;
+};
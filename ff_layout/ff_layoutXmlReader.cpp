@@ -0,0 +1,495 @@
+/*
+  ==============================================================================
+
+  Copyright (c) 2016 - 2017, Daniel Walz
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without modification,
+  are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+     list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors
+     may be used to endorse or promote products derived from this software without
+     specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+  INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+  OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+  OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    ff_layoutXmlReader.cpp
+    Created: 18 Oct 2026 10:03:27am
+
+  ==============================================================================
+*/
+
+
+#include "ff_layout.h"
+
+LayoutXmlReader::LayoutXmlReader (const juce::String& xml)
+  : text (xml),
+    input (text.getCharPointer()),
+    line (1),
+    column (1),
+    unsupported (false),
+    errorLine (0),
+    errorColumn (0)
+{
+}
+
+LayoutXmlReader::~LayoutXmlReader ()
+{
+}
+
+juce::ValueTree LayoutXmlReader::parse (const juce::String& xml, juce::String* errorMessage)
+{
+    LayoutXmlReader reader (xml);
+    juce::ValueTree tree = reader.read();
+    if (errorMessage) {
+        if (!reader.hasError()) {
+            *errorMessage = juce::String();
+        }
+        else if (reader.getErrorLine() > 0) {
+            *errorMessage = juce::String (reader.getErrorLine()) + ":" + juce::String (reader.getErrorColumn()) + ": " + reader.getErrorMessage();
+        }
+        else {
+            *errorMessage = reader.getErrorMessage();
+        }
+    }
+    return tree;
+}
+
+juce::ValueTree LayoutXmlReader::read ()
+{
+    juce::ValueTree tree = readDocument();
+    if (tree.isValid()) {
+        return tree;
+    }
+
+    // XmlDocument is the reference, so anything the reader rejects is read with it
+    const juce::String message = errorMessage;
+    const int messageLine = errorLine;
+    const int messageColumn = errorColumn;
+    tree = readWithXmlDocument();
+    if (!tree.isValid() && !unsupported) {
+        // malformed for both, the position found by the reader is more helpful
+        errorMessage = message;
+        errorLine = messageLine;
+        errorColumn = messageColumn;
+    }
+    return tree;
+}
+
+juce::ValueTree LayoutXmlReader::readDocument ()
+{
+    input = text.getCharPointer();
+    line = 1;
+    column = 1;
+    unsupported = false;
+    errorMessage = juce::String();
+    errorLine = 0;
+    errorColumn = 0;
+
+    // a byte order mark, e.g. from a file saved by a text editor
+    if (peek() == 0xfeff) {
+        ++input;
+    }
+
+    // xml declaration, comments and DOCTYPE before the root element
+    for (;;) {
+        skipWhitespace();
+        if (!startsWith ("<?") && !startsWith ("<!")) {
+            break;
+        }
+        if (!skipMarkup()) {
+            return juce::ValueTree();
+        }
+    }
+    if (peek() != '<') {
+        setError ("expected the root element");
+        return juce::ValueTree();
+    }
+
+    juce::ValueTree root;
+    juce::Array<juce::ValueTree> openElements;
+    while (!root.isValid() || openElements.size() > 0) {
+        const juce::juce_wchar c = peek();
+        if (c == 0) {
+            setError ("unexpected end of document, <" + openElements.getLast().getType().toString() + "> is not closed");
+            return juce::ValueTree();
+        }
+        if (c != '<') {
+            // text content is not used by the layout, like in ValueTree::fromXml
+            next();
+        }
+        else if (startsWith ("<?") || startsWith ("<!")) {
+            if (!skipMarkup()) {
+                return juce::ValueTree();
+            }
+        }
+        else if (startsWith ("</")) {
+            if (!readEndTag (openElements.getLast())) {
+                return juce::ValueTree();
+            }
+            openElements.removeLast();
+        }
+        else {
+            juce::ValueTree element;
+            bool isEmptyElement;
+            if (!readStartTag (element, isEmptyElement)) {
+                return juce::ValueTree();
+            }
+            // the tree is detached, so adding to it doesn't notify anybody
+            if (openElements.isEmpty()) {
+                root = element;
+            }
+            else {
+                openElements.getReference (openElements.size() - 1).appendChild (element, nullptr);
+            }
+            if (!isEmptyElement) {
+                openElements.add (element);
+            }
+        }
+    }
+
+    for (;;) {
+        skipWhitespace();
+        if (!startsWith ("<?") && !startsWith ("<!")) {
+            break;
+        }
+        if (!skipMarkup()) {
+            return juce::ValueTree();
+        }
+    }
+    if (peek() != 0) {
+        setError ("unexpected content after the root element");
+        return juce::ValueTree();
+    }
+    return root;
+}
+
+juce::ValueTree LayoutXmlReader::readWithXmlDocument ()
+{
+    errorMessage = juce::String();
+    errorLine = 0;
+    errorColumn = 0;
+
+    juce::XmlDocument document (text);
+    std::unique_ptr<juce::XmlElement> element (document.getDocumentElement());
+    if (element == nullptr) {
+        errorMessage = document.getLastParseError();
+        if (errorMessage.isEmpty()) {
+            errorMessage = "no root element";
+        }
+        return juce::ValueTree();
+    }
+    return juce::ValueTree::fromXml (*element);
+}
+
+bool LayoutXmlReader::setUnsupported ()
+{
+    unsupported = true;
+    return false;
+}
+
+bool LayoutXmlReader::hasError () const
+{
+    return errorMessage.isNotEmpty();
+}
+
+const juce::String& LayoutXmlReader::getErrorMessage () const
+{
+    return errorMessage;
+}
+
+int LayoutXmlReader::getErrorLine () const
+{
+    return errorLine;
+}
+
+int LayoutXmlReader::getErrorColumn () const
+{
+    return errorColumn;
+}
+
+juce::juce_wchar LayoutXmlReader::peek () const
+{
+    return *input;
+}
+
+juce::juce_wchar LayoutXmlReader::next ()
+{
+    const juce::juce_wchar c = input.getAndAdvance();
+    if (c == '\n') {
+        ++line;
+        column = 1;
+    }
+    else {
+        ++column;
+    }
+    return c;
+}
+
+bool LayoutXmlReader::startsWith (const char* prefix) const
+{
+    juce::String::CharPointerType p = input;
+    while (*prefix != 0) {
+        if (p.getAndAdvance() != static_cast<juce::juce_wchar> (*prefix++)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void LayoutXmlReader::skip (int numChars)
+{
+    for (int i=0; i < numChars && peek() != 0; ++i) {
+        next();
+    }
+}
+
+void LayoutXmlReader::skipWhitespace ()
+{
+    while (juce::CharacterFunctions::isWhitespace (peek())) {
+        next();
+    }
+}
+
+bool LayoutXmlReader::skipUntil (const char* terminator)
+{
+    const int length = static_cast<int> (strlen (terminator));
+    while (peek() != 0) {
+        if (startsWith (terminator)) {
+            skip (length);
+            return true;
+        }
+        next();
+    }
+    return setError (juce::String ("unexpected end of document, expected \"") + terminator + "\"");
+}
+
+bool LayoutXmlReader::skipMarkup ()
+{
+    if (startsWith ("<!--")) {
+        skip (4);
+        return skipUntil ("-->");
+    }
+    if (startsWith ("<![CDATA[")) {
+        skip (9);
+        return skipUntil ("]]>");
+    }
+    if (startsWith ("<?")) {
+        skip (2);
+        return skipUntil ("?>");
+    }
+
+    // DOCTYPE, which might contain an internal subset in brackets
+    skip (2);
+    int depth = 0;
+    while (peek() != 0) {
+        const juce::juce_wchar c = next();
+        if (c == '[') {
+            ++depth;
+        }
+        else if (c == ']') {
+            --depth;
+        }
+        else if (c == '>' && depth <= 0) {
+            return true;
+        }
+    }
+    return setError ("unexpected end of document in <!DOCTYPE>");
+}
+
+juce::String LayoutXmlReader::readName ()
+{
+    const juce::String::CharPointerType start = input;
+    const juce::juce_wchar first = peek();
+    if (!(juce::CharacterFunctions::isLetter (first) || first == '_' || first == ':')) {
+        return juce::String();
+    }
+    while (juce::CharacterFunctions::isLetterOrDigit (peek())
+           || peek() == '_' || peek() == ':' || peek() == '-' || peek() == '.') {
+        next();
+    }
+    return juce::String (start, input);
+}
+
+bool LayoutXmlReader::readStartTag (juce::ValueTree& element, bool& isEmptyElement)
+{
+    next();
+    const juce::String type = readName();
+    if (type.isEmpty()) {
+        return setError ("expected an element name");
+    }
+    element = juce::ValueTree (juce::Identifier (type));
+    isEmptyElement = false;
+
+    for (;;) {
+        skipWhitespace();
+        const juce::juce_wchar c = peek();
+        if (c == '>') {
+            next();
+            return true;
+        }
+        if (c == '/') {
+            next();
+            if (peek() != '>') {
+                return setError ("expected \">\" after \"/\" in <" + type + ">");
+            }
+            next();
+            isEmptyElement = true;
+            return true;
+        }
+        if (c == 0) {
+            return setError ("unexpected end of document in <" + type + ">");
+        }
+
+        const juce::String name = readName();
+        if (name.isEmpty()) {
+            return setError ("expected an attribute name in <" + type + ">");
+        }
+        skipWhitespace();
+        if (peek() != '=') {
+            return setError ("expected \"=\" after attribute " + name);
+        }
+        next();
+        skipWhitespace();
+
+        juce::String value;
+        if (!readAttributeValue (value)) {
+            return false;
+        }
+        // binary properties, like ValueTree::toXmlString writes them
+        if (name.startsWith ("base64:")) {
+            juce::MemoryBlock block;
+            if (block.fromBase64Encoding (value)) {
+                element.setProperty (juce::Identifier (name.substring (7)), juce::var (block), nullptr);
+                continue;
+            }
+        }
+        element.setProperty (juce::Identifier (name), value, nullptr);
+    }
+}
+
+bool LayoutXmlReader::readEndTag (const juce::ValueTree& element)
+{
+    skip (2);
+    const juce::String type = readName();
+    const juce::String expected = element.getType().toString();
+    if (type != expected) {
+        return setError ("expected </" + expected + ">");
+    }
+    skipWhitespace();
+    if (peek() != '>') {
+        return setError ("expected \">\" to close </" + expected + ">");
+    }
+    next();
+    return true;
+}
+
+bool LayoutXmlReader::readAttributeValue (juce::String& value)
+{
+    const juce::juce_wchar quote = peek();
+    if (quote != '"' && quote != '\'') {
+        return setError ("expected a quoted attribute value");
+    }
+    next();
+
+    // copy runs of plain characters at once, only entities are decoded one by one
+    juce::String::CharPointerType start = input;
+    for (;;) {
+        const juce::juce_wchar c = peek();
+        if (c == quote) {
+            value += juce::String (start, input);
+            next();
+            return true;
+        }
+        if (c == 0) {
+            return setError ("unterminated attribute value");
+        }
+        if (c == '&') {
+            value += juce::String (start, input);
+            if (!readEntity (value)) {
+                return false;
+            }
+            start = input;
+        }
+        else {
+            next();
+        }
+    }
+}
+
+bool LayoutXmlReader::readEntity (juce::String& value)
+{
+    next();
+    if (peek() == '#') {
+        next();
+        const bool hex = (peek() == 'x' || peek() == 'X');
+        if (hex) {
+            next();
+        }
+        juce::uint32 code = 0;
+        int numDigits = 0;
+        for (;;) {
+            const int digit = hex ? juce::CharacterFunctions::getHexDigitValue (peek())
+                                  : (juce::CharacterFunctions::isDigit (peek()) ? static_cast<int> (peek() - '0') : -1);
+            if (digit < 0) {
+                break;
+            }
+            code = code * (hex ? 16 : 10) + static_cast<juce::uint32> (digit);
+            ++numDigits;
+            next();
+        }
+        if (numDigits == 0 || peek() != ';') {
+            return setUnsupported();
+        }
+        next();
+        value += juce::String::charToString (static_cast<juce::juce_wchar> (code));
+        return true;
+    }
+
+    const juce::String::CharPointerType start = input;
+    while (juce::CharacterFunctions::isLetterOrDigit (peek())) {
+        next();
+    }
+    const juce::String name (start, input);
+    if (peek() != ';') {
+        return setUnsupported();
+    }
+    next();
+
+    if      (name == "amp")  value += "&";
+    else if (name == "lt")   value += "<";
+    else if (name == "gt")   value += ">";
+    else if (name == "quot") value += "\"";
+    else if (name == "apos") value += "'";
+    else {
+        // might be declared in the DOCTYPE, which is left to the XmlDocument
+        return setUnsupported();
+    }
+    return true;
+}
+
+bool LayoutXmlReader::setError (const juce::String& message)
+{
+    errorMessage = message;
+    errorLine = line;
+    errorColumn = column;
+    return false;
+}
@@ -0,0 +1,152 @@
+/*
+  ==============================================================================
+
+  Copyright (c) 2016 - 2017, Daniel Walz
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without modification,
+  are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+     list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors
+     may be used to endorse or promote products derived from this software without
+     specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+  INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+  OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+  OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    ff_layoutXmlReader.h
+    Created: 18 Oct 2026 10:03:27am
+
+  ==============================================================================
+*/
+
+#pragma once
+
+
+//==============================================================================
+/**
+ The LayoutXmlReader builds the ValueTree of a layout xml directly from the text,
+ without a juce::XmlElement tree in between. The result is the same as from
+ juce::XmlDocument::parse followed by juce::ValueTree::fromXml: each element
+ becomes a node of that type, each attribute a string property, and attributes
+ prefixed with "base64:" become binary properties. Text, comments, CDATA sections,
+ processing instructions and the DOCTYPE are skipped.
+
+ Entities other than the five predefined ones, e.g. declared in the DOCTYPE, are
+ not resolved by the reader. In that case, and whenever the reader fails, the
+ document is read again using juce::XmlDocument, so the reader never rejects a
+ document juce::XmlDocument accepts.
+
+ Errors are reported with the line and column, where the reader stopped. Errors
+ found only by the juce::XmlDocument fallback have no position.
+
+ The module built with FF_LAYOUT_BENCHMARKS contains a benchmark comparing the
+ reader with juce::XmlDocument::parse and juce::ValueTree::fromXml.
+
+ @see Layout::Layout (const juce::String&, juce::Component*)
+ */
+class LayoutXmlReader
+{
+public:
+    LayoutXmlReader (const juce::String& xml);
+    ~LayoutXmlReader ();
+
+    /** Read the document. Returns an invalid tree, if the xml is malformed */
+    juce::ValueTree read ();
+
+    /** Returns true, if the last read failed */
+    bool hasError () const;
+
+    /** Returns the reason why the last read failed */
+    const juce::String& getErrorMessage () const;
+
+    /** Returns the line, where the last read failed, starting at 1, or 0 if unknown */
+    int getErrorLine () const;
+
+    /** Returns the column, where the last read failed, starting at 1, or 0 if unknown */
+    int getErrorColumn () const;
+
+    /**
+     Read a layout xml into a ValueTree. If the xml is malformed, an invalid tree
+     is returned and errorMessage is set to "line:column: reason".
+     */
+    static juce::ValueTree parse (const juce::String& xml, juce::String* errorMessage=nullptr);
+
+private:
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LayoutXmlReader)
+
+    /** @internal */
+    juce::ValueTree readDocument ();
+
+    /** @internal */
+    juce::ValueTree readWithXmlDocument ();
+
+    /** @internal */
+    bool setUnsupported ();
+
+    /** @internal */
+    juce::juce_wchar peek () const;
+
+    /** @internal */
+    juce::juce_wchar next ();
+
+    /** @internal */
+    bool startsWith (const char* text) const;
+
+    /** @internal */
+    void skip (int numChars);
+
+    /** @internal */
+    void skipWhitespace ();
+
+    /** @internal */
+    bool skipUntil (const char* terminator);
+
+    /** @internal */
+    bool skipMarkup ();
+
+    /** @internal */
+    juce::String readName ();
+
+    /** @internal */
+    bool readStartTag (juce::ValueTree& element, bool& isEmptyElement);
+
+    /** @internal */
+    bool readEndTag (const juce::ValueTree& element);
+
+    /** @internal */
+    bool readAttributeValue (juce::String& value);
+
+    /** @internal */
+    bool readEntity (juce::String& value);
+
+    /** @internal */
+    bool setError (const juce::String& message);
+
+    juce::String                text;
+    juce::String::CharPointerType input;
+    int                         line;
+    int                         column;
+    bool                        unsupported;
+
+    juce::String                errorMessage;
+    int                         errorLine;
+    int                         errorColumn;
+};